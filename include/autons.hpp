@@ -16,6 +16,15 @@ void odom_pure_pursuit_wait_until_example();
 void odom_boomerang_example();
 void odom_boomerang_injected_pure_pursuit_example();
 void measure_offsets();
+void measure_turn_limits();
+void profiled_turn_example();
+void windowed_pursuit_example();
+void measure_latency();
+void measure_thermal();
+void sd_card_route();
+void replay_driver();
+void run_benchmarks();
+void exit_simulation();
 
 void sev_twoGoal_blue();
 void sev_twoGoal_red();
@@ -32,4 +41,5 @@ void hi();
 
 void nineBlock();
 void fullSkills();
+std::vector<ez::Auton> fullSkillsSegments();
 
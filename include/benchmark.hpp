@@ -0,0 +1,91 @@
+#pragma once
+
+#include "EZ-Template/api.hpp"
+#include "api.h"
+
+/**
+ * Times code and checks it against a budget.
+ *
+ * It runs on the brain, and tools/tick_benchmark.cpp runs it on a computer
+ * for everything that doesn't need EZ-Template's prebuilt library.
+ *
+ * Each case runs its own loop, so the cost of calling it isn't counted per
+ * operation.  Every case is run a few times and the fastest is kept, because
+ * other tasks can only ever make a run slower.  The cost of an empty loop is
+ * taken off each result, so what's left is the code itself.
+ */
+class benchmark {
+ public:
+  /**
+   * Most cases that can be added.
+   */
+  static const int MAX_CASES = 24;
+
+  /**
+   * Result of one case.
+   */
+  struct result {
+    const char* name;
+    double ns_per_op;
+    double budget;
+    bool passed;
+  };
+
+  benchmark();
+
+  /**
+   * Adds a case.  Returns false if there's no room.
+   *
+   * \param name
+   *        name printed with the result
+   * \param budget
+   *        most nanoseconds each operation can take before it fails
+   * \param body
+   *        runs the operation this many times, passing each result to sink()
+   */
+  bool add(const char* name, double budget, std::function<void(int)> body);
+
+  /**
+   * Removes every case.
+   */
+  void clear();
+
+  /**
+   * Runs every case, prints a table of the results, and returns how many went over budget.
+   *
+   * \param iterations
+   *        how many operations each run times
+   * \param repeats
+   *        how many runs each case gets, the fastest is kept
+   */
+  int run(int iterations = 10000, int repeats = 5);
+
+  /**
+   * Returns the results from the last run.
+   */
+  std::vector<result> results_get();
+
+  /**
+   * Keeps a result alive so the compiler can't remove the work that made it.
+   */
+  inline void sink(double input) { sunk = input; }
+
+ private:
+  struct bench_case {
+    const char* name;
+    double budget;
+    std::function<void(int)> body;
+  };
+
+  bench_case cases[MAX_CASES];
+  result results[MAX_CASES];
+  int count = 0;
+  volatile double sunk = 0.0;
+
+  double time(const std::function<void(int)>& body, int iterations, int repeats);
+};
+
+/**
+ * Global benchmark.
+ */
+extern benchmark bench;
@@ -0,0 +1,151 @@
+#pragma once
+
+#include "EZ-Template/api.hpp"
+#include "api.h"
+
+/**
+ * Boomerang motion that follows a velocity profile.
+ *
+ * The robot drives at a carrot point placed behind the target along the target
+ * angle, the same as chassis.pid_odom_boomerang_set().  Speed is capped by how far
+ * is left along the curve through the carrot, so the robot brakes at the measured
+ * deceleration instead of overshooting, and by how far the robot is pointed away
+ * from the carrot.
+ *
+ * Each tick the time left to settle is predicted from the robot's velocity.  Once
+ * braking from the current speed would stop the robot within the exit tolerance,
+ * the target is handed to chassis.pid_odom_set() to hold and pid_wait() returns,
+ * so the end of the motion doesn't crawl in on small error.
+ */
+class boomerang_profile {
+ public:
+  boomerang_profile();
+
+  /**
+   * Starts a profiled boomerang motion.
+   *
+   * \param imovement
+   *        an odom movement with an angle, the same as chassis.pid_odom_boomerang_set().  A max_xy_speed
+   *        of 0 hands it to chassis.pid_odom_boomerang_set()
+   */
+  void pid_boomerang_set(ez::odom imovement);
+
+  /**
+   * Starts a profiled boomerang motion.
+   *
+   * \param p_imovement
+   *        a united odom movement with an angle, the same as chassis.pid_odom_boomerang_set()
+   */
+  void pid_boomerang_set(ez::united_odom p_imovement);
+
+  /**
+   * Blocks until the motion is predicted to settle, or times out.
+   */
+  void pid_wait();
+
+  /**
+   * Stops the motion and the drive.
+   */
+  void stop();
+
+  /**
+   * Returns true while a motion is running.
+   */
+  bool enabled();
+
+  /**
+   * Sets the limits of the drivetrain when driving straight.
+   *
+   * \param max_velocity
+   *        inches per second at full power
+   * \param accel
+   *        how quickly the robot speeds up, inches per second per second
+   * \param decel
+   *        how quickly the robot brakes, inches per second per second
+   */
+  void limits_set(double max_velocity, double accel, double decel);
+
+  /**
+   * Returns the limits, {max_velocity, accel, decel}.
+   */
+  std::vector<double> limits_get();
+
+  /**
+   * Sets the feedback on the profile.
+   *
+   * \param kp_velocity
+   *        output per inch per second the robot is off the profile's velocity
+   * \param kp_heading
+   *        output per degree the robot is pointed away from the carrot
+   */
+  void constants_set(double kp_velocity, double kp_heading);
+
+  /**
+   * Returns the feedback constants, {kp_velocity, kp_heading}.
+   */
+  std::vector<double> constants_get();
+
+  /**
+   * Sets when the motion is done.
+   *
+   * \param p_tolerance
+   *        how close to the target the robot is predicted to stop, an okapi distance unit
+   * \param p_angle_tolerance
+   *        how close to the target angle the robot needs to be, an okapi angle unit
+   */
+  void exit_condition_set(okapi::QLength p_tolerance, okapi::QAngle p_angle_tolerance);
+
+  /**
+   * Returns the distance left along the curve through the carrot, in inches.
+   */
+  double remaining_get();
+
+  /**
+   * Returns the predicted time until the motion settles, in ms.
+   */
+  double settle_time_get();
+
+  /**
+   * Returns the velocity the profile is asking for, in inches per second.
+   */
+  double profile_velocity_get();
+
+  /**
+   * Returns the measured velocity along the robot's heading, in inches per second.
+   */
+  double velocity_get();
+
+  /**
+   * Runs one iteration of the motion.  This is called by the boomerang task.
+   */
+  void iterate();
+
+ private:
+  double MAX_VELOCITY = 65.0;
+  double ACCEL = 150.0;
+  double DECEL = 120.0;
+  double KP_VELOCITY = 1.5;
+  double KP_HEADING = 2.0;
+  double TOLERANCE = 1.0;
+  double ANGLE_TOLERANCE = 3.0;
+
+  bool running = false;
+  ez::odom target = {{0.0, 0.0, 0.0}, ez::fwd, 127};
+  double velocity_max = 65.0;
+  double profile_velocity = 0.0;
+  double velocity = 0.0;
+  double remaining = 0.0;
+  double settle_time = 0.0;
+  ez::pose last_pose = {0.0, 0.0, 0.0};
+  int last_time = 0;
+  int start_time = 0;
+  int timeout = 0;
+
+  ez::pose carrot_get(ez::pose current);
+  void velocity_update(ez::pose current);
+};
+
+/**
+ * Global profiled boomerang.
+ */
+extern boomerang_profile fast_boomerang;
@@ -0,0 +1,166 @@
+#pragma once
+
+#include "EZ-Template/api.hpp"
+#include "api.h"
+
+/**
+ * Controller input for driver control that can be recorded and replayed.
+ *
+ * Driver control reads the controller through this instead of master, so a
+ * replayed run goes through exactly the same code as a live one.  Each tick
+ * the sticks, buttons and robot pose are recorded into a small buffer, and the
+ * recorder task writes it out to the SD card every 100ms, so nothing builds up
+ * in memory and driver control never waits on the card.  Samples only store
+ * what changed since the last one, so a full minute fits in well under 100KB.
+ *
+ * While replaying, the recorded pose is compared against odom and the sticks are
+ * nudged to pull the robot back onto the recorded run.  This assumes split
+ * arcade, with the left stick driving and the right stick turning.
+ */
+class driver_input {
+ public:
+  driver_input();
+
+  /**
+   * Takes a new sample, from the controller or the recording being replayed.  Call this once at the top of every driver control tick.
+   */
+  void iterate();
+
+  /**
+   * Returns a stick, -127 to 127.
+   *
+   * \param channel
+   *        the stick, ANALOG_LEFT_X, ANALOG_LEFT_Y, ANALOG_RIGHT_X or ANALOG_RIGHT_Y
+   */
+  int get_analog(pros::controller_analog_e_t channel);
+
+  /**
+   * Returns true while a button is held.
+   *
+   * \param button
+   *        the button, DIGITAL_L1 through DIGITAL_A
+   */
+  bool get_digital(pros::controller_digital_e_t button);
+
+  /**
+   * Returns true on the tick a button is pressed.
+   *
+   * \param button
+   *        the button, DIGITAL_L1 through DIGITAL_A
+   */
+  bool get_digital_new_press(pros::controller_digital_e_t button);
+
+  /**
+   * Starts recording to a file on the SD card.  The starting pose is taken from odom.
+   *
+   * Returns false if the file couldn't be opened.
+   *
+   * \param file
+   *        file on the SD card, like "/usd/driver.rec"
+   */
+  bool record_start(std::string file);
+
+  /**
+   * Stops recording and writes what's left to the SD card.  Returns false if any of it couldn't be written.
+   */
+  bool record_stop();
+
+  /**
+   * Returns true while recording.
+   */
+  bool recording();
+
+  /**
+   * Loads a recording from the SD card and starts replaying it.  Odom is set to the recording's starting pose.
+   *
+   * Returns false if the file couldn't be read.
+   *
+   * \param file
+   *        file on the SD card, like "/usd/driver.rec"
+   */
+  bool replay_start(std::string file);
+
+  /**
+   * Stops replaying and goes back to the controller.
+   */
+  void replay_stop();
+
+  /**
+   * Returns true while replaying.
+   */
+  bool replaying();
+
+  /**
+   * Sets how hard replays pull the robot back onto the recorded pose.
+   *
+   * \param kp_drive
+   *        left stick added per inch the robot is behind the recording
+   * \param kp_turn
+   *        right stick added per degree the robot is turned away from the recording
+   */
+  void correction_constants_set(double kp_drive, double kp_turn);
+
+  /**
+   * Returns the correction constants, {kp_drive, kp_turn}.
+   */
+  std::vector<double> correction_constants_get();
+
+  /**
+   * Writes what's been recorded since the last call to the SD card.  This is called by the recorder task.
+   */
+  void flush();
+
+ private:
+  struct sample {
+    int time = 0;
+    std::int8_t analog[4] = {0, 0, 0, 0};
+    std::uint16_t buttons = 0;
+    ez::pose pose = {0.0, 0.0, 0.0};
+  };
+
+  double KP_DRIVE = 3.0;
+  double KP_TURN = 1.5;
+
+  sample current;
+  std::uint16_t last_buttons = 0;
+  bool is_recording = false;
+  bool is_replaying = false;
+  int start_time = 0;
+
+  static const int BUFFER_BYTES = 4096;
+  std::uint8_t pending[BUFFER_BYTES];
+  int pending_size = 0;
+  FILE* record_file = nullptr;
+  int record_bytes = 0;
+  bool record_failed = false;
+  pros::Mutex driver_lock;
+  pros::Mutex file_lock;
+
+  std::vector<std::uint8_t> data;
+  sample encoded;
+  int read_index = 0;
+  sample next;
+  bool has_next = false;
+
+  sample controller_sample();
+  void encode(const sample& input);
+  bool decode(sample& output);
+};
+
+/**
+ * Global driver input.
+ */
+extern driver_input driver;
+
+/**
+ * Runs one tick of driver control.  Defined in main.cpp.
+ */
+void opcontrol_iterate();
+
+/**
+ * Runs the routine driver control last started with a button, if there is one.  Defined in main.cpp.
+ *
+ * Routines block until they're done, so opcontrol_iterate() only queues them and
+ * whatever loops on it runs them, outside the executive's frame.
+ */
+void opcontrol_routine_run();
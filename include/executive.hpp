@@ -0,0 +1,164 @@
+#pragma once
+
+#include "EZ-Template/api.hpp"
+#include "api.h"
+
+/**
+ * Runs every registered subsystem in one fixed order, once a frame.
+ *
+ * Without it, each module here runs in its own task and wakes up whenever the
+ * scheduler gets to it, so a motor can be written with a reading up to a tick
+ * old.  With it enabled, one task runs every step in phase order, sense then
+ * estimate then control then actuate, on a fixed frame.  Everything a step reads
+ * is from earlier in the same frame, so the time from reading a sensor to writing
+ * a motor is never more than one frame.
+ *
+ * The module tasks keep running while it's disabled, so it can be switched on
+ * and off at any time.  EZ-Template's own odom and PID tasks aren't part of it.
+ */
+class cyclic_executive {
+ public:
+  /**
+   * Enum for the phases of a frame, run in this order.
+   */
+  enum e_phase { SENSE = 0,
+                 ESTIMATE = 1,
+                 CONTROL = 2,
+                 ACTUATE = 3 };
+
+  /**
+   * Number of phases.
+   */
+  static const int PHASES = 4;
+
+  /**
+   * Most steps that can be registered.
+   */
+  static const int MAX_STEPS = 24;
+
+  cyclic_executive();
+
+  /**
+   * Registers a step.  Steps in the same phase run in the order they're added.  Returns false if there's no room.
+   *
+   * \param phase
+   *        SENSE, ESTIMATE, CONTROL or ACTUATE
+   * \param name
+   *        name used by active_set() and print()
+   * \param step
+   *        runs once a frame
+   */
+  bool add(e_phase phase, const char* name, std::function<void()> step);
+
+  /**
+   * Turns a step on or off without removing it.
+   *
+   * \param name
+   *        name the step was added with
+   * \param input
+   *        true runs the step, false skips it
+   */
+  void active_set(const char* name, bool input);
+
+  /**
+   * Returns true if a step is on, false if it's off or there isn't one with that name.
+   */
+  bool active_get(const char* name);
+
+  /**
+   * Enables or disables the executive.  While disabled, each module runs in its own task.
+   *
+   * \param input
+   *        true enables, false disables
+   */
+  void enable(bool input);
+
+  /**
+   * Returns true while the executive is running the steps.
+   */
+  bool enabled();
+
+  /**
+   * Sets how long a frame is.  The modules here step in ez::util::DELAY_TIME,
+   * so only go faster with steps that measure their own time between frames.
+   *
+   * \param p_period
+   *        an okapi time unit, 1ms or more
+   */
+  void period_set(okapi::QTime p_period);
+
+  /**
+   * Returns how long a frame is, in ms.
+   */
+  int period_get();
+
+  /**
+   * Returns how long a phase took in the last frame, in microseconds.
+   *
+   * \param phase
+   *        SENSE, ESTIMATE, CONTROL or ACTUATE
+   */
+  int phase_time_get(e_phase phase);
+
+  /**
+   * Returns the longest a phase has taken since timing_reset(), in microseconds.
+   *
+   * \param phase
+   *        SENSE, ESTIMATE, CONTROL or ACTUATE
+   */
+  int phase_time_max_get(e_phase phase);
+
+  /**
+   * Returns how long the last frame took to run, in microseconds.
+   */
+  int frame_time_get();
+
+  /**
+   * Returns the longest a frame has taken since timing_reset(), in microseconds.
+   */
+  int frame_time_max_get();
+
+  /**
+   * Returns how many frames took longer than the period since timing_reset().
+   */
+  int overruns_get();
+
+  /**
+   * Clears the longest times and overruns.
+   */
+  void timing_reset();
+
+  /**
+   * Prints the steps and how long each phase takes to the terminal.
+   */
+  void print();
+
+  /**
+   * Runs one frame.  This is called by the executive task.
+   */
+  void iterate();
+
+ private:
+  struct step_t {
+    e_phase phase;
+    const char* name;
+    std::function<void()> step;
+    bool active;
+  };
+
+  step_t steps[MAX_STEPS];
+  int count = 0;
+  int period = 10;
+  bool running = false;
+
+  int phase_time[PHASES] = {0, 0, 0, 0};
+  int phase_time_max[PHASES] = {0, 0, 0, 0};
+  int frame_time = 0;
+  int frame_time_max = 0;
+  int overruns = 0;
+};
+
+/**
+ * Global cyclic executive.
+ */
+extern cyclic_executive executive;
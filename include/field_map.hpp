@@ -0,0 +1,122 @@
+#pragma once
+
+#include "EZ-Template/api.hpp"
+#include "api.h"
+
+struct _lv_obj_t;
+
+/**
+ * Field map for the brain screen, with the robot, the pure pursuit path and where the robot has been.
+ *
+ * Everything is made once in initialize(), and each frame only moves what
+ * changed by at least a pixel, so LVGL only redraws the small areas around
+ * them.  The trail is a fixed ring of dots that only takes a new point once the
+ * robot has moved far enough from the last one, and the oldest dot is moved to
+ * it.  Updates run in an LVGL timer, so the map never touches LVGL from another
+ * task.
+ */
+class field_map {
+ public:
+  /**
+   * Dots kept in the trail.
+   */
+  static const int TRAIL_SIZE = 48;
+
+  /**
+   * Most points drawn for the path, longer paths are thinned out.
+   */
+  static const int PATH_SIZE = 64;
+
+  field_map();
+
+  /**
+   * Makes the map.  Call this once after ez::as::initialize().
+   */
+  void initialize();
+
+  /**
+   * Shows or hides the map.  Hiding goes back to whatever was on the screen before.
+   *
+   * \param input
+   *        true shows the map
+   */
+  void show(bool input);
+
+  /**
+   * Returns true while the map is showing.
+   */
+  bool showing();
+
+  /**
+   * Returns true once after the map is tapped.
+   */
+  bool tapped();
+
+  /**
+   * Sets the area of the field the map covers.
+   *
+   * \param p_x_min
+   *        left edge, an okapi distance unit
+   * \param p_y_min
+   *        bottom edge, an okapi distance unit
+   * \param p_size
+   *        width and height, an okapi distance unit
+   */
+  void bounds_set(okapi::QLength p_x_min, okapi::QLength p_y_min, okapi::QLength p_size);
+
+  /**
+   * Sets how far the robot has to move before the trail takes a new point.
+   *
+   * \param p_spacing
+   *        an okapi distance unit
+   */
+  void trail_spacing_set(okapi::QLength p_spacing);
+
+  /**
+   * Removes every point from the trail.
+   */
+  void trail_clear();
+
+  /**
+   * Updates the map.  This is called by the map's LVGL timer.
+   */
+  void update();
+
+ private:
+  double X_MIN = -72.0;
+  double Y_MIN = 0.0;
+  double SIZE = 144.0;
+  double TRAIL_SPACING = 2.0;
+
+  _lv_obj_t* screen = nullptr;
+  _lv_obj_t* previous = nullptr;
+  _lv_obj_t* map = nullptr;
+  _lv_obj_t* robot = nullptr;
+  _lv_obj_t* heading = nullptr;
+  _lv_obj_t* path = nullptr;
+  _lv_obj_t* label = nullptr;
+  _lv_obj_t* trail[TRAIL_SIZE];
+
+  int robot_x = -1;
+  int robot_y = -1;
+  int tip_x = -1;
+  int tip_y = -1;
+  ez::pose trail_last = {1000.0, 1000.0, 0.0};
+  int trail_head = 0;
+  bool clear_trail = false;
+  int path_version = -1;
+  char text[64];
+
+  volatile bool requested = false;
+  volatile bool is_showing = false;
+  volatile bool was_tapped = false;
+
+  int x_px(double x);
+  int y_px(double y);
+  void path_update();
+};
+
+/**
+ * Global field map.
+ */
+extern field_map dashboard;
@@ -0,0 +1,146 @@
+#pragma once
+
+#include "EZ-Template/api.hpp"
+#include "api.h"
+
+/**
+ * Table of PID constants that get interpolated at the start of a motion.
+ *
+ * Each point pairs a key (max speed or distance) with a set of constants.  Keys
+ * between two points linearly blend their constants, keys outside the table use
+ * the closest point.
+ */
+class gain_schedule {
+ public:
+  /**
+   * Enum for what the table is indexed by.
+   */
+  enum e_index { SPEED = 0,
+                 DISTANCE = 1 };
+
+  /**
+   * Struct for one row of the table.
+   */
+  struct point {
+    double key;
+    ez::PID::Constants constants;
+  };
+
+  /**
+   * Default constructor, an empty table is disabled.
+   */
+  gain_schedule();
+
+  /**
+   * Constructor with a table.
+   *
+   * \param points
+   *        rows of the table, they do not need to be sorted
+   * \param index
+   *        SPEED or DISTANCE, what the keys represent
+   */
+  gain_schedule(std::vector<point> points, e_index index = SPEED);
+
+  /**
+   * Sets the table.
+   *
+   * \param points
+   *        rows of the table, they do not need to be sorted
+   * \param index
+   *        SPEED or DISTANCE, what the keys represent
+   */
+  void points_set(std::vector<point> points, e_index index = SPEED);
+
+  /**
+   * Returns the rows of the table, sorted by key.
+   */
+  std::vector<point> points_get();
+
+  /**
+   * Returns what the table is indexed by.
+   */
+  e_index index_get();
+
+  /**
+   * Returns true if the table has at least one row.
+   */
+  bool enabled();
+
+  /**
+   * Returns interpolated constants for a motion.
+   *
+   * \param speed
+   *        max speed of the motion, 0 - 127
+   * \param distance
+   *        absolute distance of the motion, inches or degrees
+   */
+  ez::PID::Constants constants_get(double speed, double distance);
+
+ private:
+  std::vector<point> table;
+  e_index index_type = SPEED;
+};
+
+/**
+ * Gain schedules used by the scheduled motions below.
+ */
+extern gain_schedule drive_forward_gains;
+extern gain_schedule drive_backward_gains;
+extern gain_schedule turn_gains;
+extern gain_schedule swing_gains;
+
+/**
+ * Sets the drive to go forward using PID, with constants picked from
+ * drive_forward_gains, or drive_backward_gains if it has any rows.
+ *
+ * Only this motion uses the scheduled constants, later motions use the ones they had before.
+ *
+ * \param p_target
+ *        target value as a distance, an okapi distance unit
+ * \param speed
+ *        0 to 127, max speed during motion
+ * \param slew_on
+ *        ramp up from a lower speed to your target speed
+ * \param toggle_heading
+ *        toggle for heading correction
+ */
+void pid_drive_scheduled_set(okapi::QLength p_target, int speed, bool slew_on = false, bool toggle_heading = true);
+
+/**
+ * Sets the robot to turn relative to initial heading using PID, with constants
+ * picked from turn_gains.
+ *
+ * The turn constants are put back once the turn settles or another motion starts.
+ *
+ * \param p_target
+ *        target value as an angle, an okapi angle unit
+ * \param speed
+ *        0 to 127, max speed during motion
+ * \param slew_on
+ *        ramp up from a lower speed to your target speed
+ */
+void pid_turn_scheduled_set(okapi::QAngle p_target, int speed, bool slew_on = false);
+
+/**
+ * Sets the robot to swing relative to initial heading using PID, with constants
+ * picked from swing_gains.
+ *
+ * Only this motion uses the scheduled constants, later motions use the ones they had before.
+ *
+ * \param type
+ *        L_SWING or R_SWING
+ * \param p_target
+ *        target value as an angle, an okapi angle unit
+ * \param speed
+ *        0 to 127, max speed during motion
+ * \param opposite_speed
+ *        -127 to 127, max speed of the opposite side of the drive during the swing
+ * \param slew_on
+ *        ramp up from a lower speed to your target speed
+ */
+void pid_swing_scheduled_set(ez::e_swing type, okapi::QAngle p_target, int speed, int opposite_speed = 0, bool slew_on = false);
+
+/**
+ * Puts the turn constants back once a scheduled turn is over.  This is called by the gain schedule task.
+ */
+void gain_schedule_iterate();
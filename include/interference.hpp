@@ -0,0 +1,155 @@
+#pragma once
+
+#include "EZ-Template/api.hpp"
+#include "api.h"
+
+/**
+ * Notices when the robot is blocked mid motion, and recovers from it.
+ *
+ * Each tick, every drive motor's voltage says how fast it should be spinning.
+ * That speed is lagged by how long the robot takes to get up to speed, so
+ * speeding up from rest isn't mistaken for being blocked.  A side spinning well
+ * under it while drawing a lot of current is being held back.  That only has
+ * to last for the detect time, so the robot is flagged long before the exit
+ * conditions time out.
+ *
+ * step() runs one motion of an auton.  When it's blocked, the recovery policy
+ * decides whether to try the motion again or skip it.
+ */
+class interference_guard {
+ public:
+  /**
+   * A recovery policy.  Given which attempt this is, starting at 0, it does
+   * whatever it needs to and returns true to try the motion again or false to skip it.
+   */
+  typedef std::function<bool(int)> recovery;
+
+  interference_guard();
+
+  /**
+   * Backs off the way the robot came and tries again.
+   *
+   * \param p_distance
+   *        how far to back off, an okapi distance unit
+   * \param attempts
+   *        how many times to back off before skipping
+   */
+  static recovery back_off(okapi::QLength p_distance, int attempts);
+
+  /**
+   * Turns left and right to work free of whatever's caught, then tries again.
+   *
+   * \param p_angle
+   *        how far to turn each way, an okapi angle unit
+   * \param attempts
+   *        how many times to wiggle before skipping
+   */
+  static recovery wiggle(okapi::QAngle p_angle, int attempts);
+
+  /**
+   * Skips the motion straight away.
+   */
+  static recovery skip();
+
+  /**
+   * Sets what step() does when the robot is blocked.
+   *
+   * \param input
+   *        back_off(), wiggle(), skip() or your own
+   */
+  void recovery_set(recovery input);
+
+  /**
+   * Starts a motion and waits on it, recovering when it's blocked.  Returns true if the motion finished, false if it was skipped.
+   *
+   * Retries start the motion again from wherever recovery left the robot, so
+   * absolute odom motions retry cleanly and relative ones go their distance again.
+   *
+   * \param motion
+   *        starts the motion, ie [] { chassis.pid_odom_set({{0_in, 24_in}, ez::fwd, 110}); }
+   */
+  bool step(std::function<void()> motion);
+
+  /**
+   * Blocks until the motion exits or the robot is blocked.  Blocking stops the drive and sets chassis.interfered.
+   *
+   * Works with drive, turn, swing and point to point odom motions.  Pure
+   * pursuit waits with chassis.pid_wait() and isn't stopped early.
+   */
+  void pid_wait();
+
+  /**
+   * Enables or disables watching for blocks.  Disable it for motions that push on purpose.
+   *
+   * \param input
+   *        true enables, false disables
+   */
+  void enable(bool input);
+
+  /**
+   * Returns true while watching for blocks.
+   */
+  bool enabled();
+
+  /**
+   * Returns true while the robot is blocked.
+   */
+  bool blocked();
+
+  /**
+   * Returns 1 if the robot was blocked driving forwards and -1 if backwards.
+   */
+  int direction_get();
+
+  /**
+   * Returns how many times step() has had to recover since the program started.
+   */
+  int recoveries_get();
+
+  /**
+   * Sets what counts as blocked.
+   *
+   * \param speed_ratio
+   *        blocked below this fraction of the speed the voltage should give, 0 to 1
+   * \param current_mA
+   *        and drawing more than this current
+   * \param p_detect_time
+   *        for this long, an okapi time unit
+   */
+  void detection_set(double speed_ratio, int current_mA, okapi::QTime p_detect_time);
+
+  /**
+   * Sets how long the robot takes to get most of the way up to speed from rest.
+   *
+   * \param p_lag
+   *        an okapi time unit
+   */
+  void lag_set(okapi::QTime p_lag);
+
+  /**
+   * Checks the drive for blocks.  This is called by the interference task.
+   */
+  void iterate();
+
+ private:
+  double SPEED_RATIO = 0.3;
+  int CURRENT_MA = 1800;
+  int DETECT_TIME = 100;
+  double LAG = 0.15;
+
+  recovery policy = nullptr;
+  bool running = true;
+  bool is_blocked = false;
+  int blocked_time = 0;
+  int direction = 1;
+  int recoveries = 0;
+  double expected[2] = {0.0, 0.0};
+
+  void clear();
+  bool side_blocked(std::vector<pros::Motor>& motors, double& expected_rpm);
+};
+
+/**
+ * Global interference guard.
+ */
+extern interference_guard guard;
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "EZ-Template/api.hpp"
+#include "api.h"
+
+/**
+ * Predicts where the robot will be by the time a command sent now takes effect.
+ *
+ * A command written this tick only moves the wheels after the pose it was
+ * worked out from has aged, the loop has come around and the motors have ramped
+ * up.  At speed that's inches of travel, so pure pursuit and boomerang steer
+ * for where the robot already was.  This tracks the robot's speed and turn rate
+ * from odom and carries the pose forward along an arc by the measured delay.
+ * The controllers pick their look ahead point and carrot from that pose.
+ *
+ * measure() finds the delay on the robot.
+ */
+class latency_compensation {
+ public:
+  latency_compensation();
+
+  /**
+   * Sets how far ahead the pose is predicted.
+   *
+   * \param p_delay
+   *        an okapi time unit, from measure()
+   */
+  void delay_set(okapi::QTime p_delay);
+
+  /**
+   * Returns how far ahead the pose is predicted, in ms.
+   */
+  int delay_get();
+
+  /**
+   * Enables or disables prediction.  While disabled, pose_predict() returns the pose it's given.
+   *
+   * \param input
+   *        true enables, false disables
+   */
+  void enable(bool input);
+
+  /**
+   * Returns true while poses are being predicted.
+   */
+  bool enabled();
+
+  /**
+   * Returns where the robot will be after the delay, from where it is now.
+   *
+   * \param current
+   *        the robot's pose now
+   */
+  ez::pose pose_predict(ez::pose current);
+
+  /**
+   * Returns the robot's speed along its heading, in inches per second.
+   */
+  double velocity_get();
+
+  /**
+   * Returns the robot's turn rate, in degrees per second clockwise.
+   */
+  double angular_velocity_get();
+
+  /**
+   * Steps the drive from rest a few times, and times how long the wheels take to
+   * reach half of the speed they settle at.  Sets the delay and returns it in ms.
+   *
+   * \param trials
+   *        steps to average, they alternate forwards and backwards
+   * \param speed
+   *        0 to 127, how hard each step drives
+   */
+  int measure(int trials = 6, int speed = 80);
+
+  /**
+   * Updates the speed and turn rate from odom.  This is called by the latency task.
+   */
+  void iterate();
+
+ private:
+  int DELAY = 50;
+
+  bool running = false;
+  double velocity = 0.0;
+  double angular_velocity = 0.0;
+  ez::pose last_pose = {0.0, 0.0, 0.0};
+  std::uint64_t last_time = 0;
+};
+
+/**
+ * Global latency compensation.
+ */
+extern latency_compensation latency;
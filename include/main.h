@@ -46,6 +46,27 @@
 // More includes here...
 #include "autons.hpp"
 #include "subsystems.hpp"
+#include "gain_schedule.hpp"
+#include "path.hpp"
+#include "pursuit.hpp"
+#include "turn_profile.hpp"
+#include "motion_events.hpp"
+#include "boomerang_profile.hpp"
+#include "traction.hpp"
+#include "thermal.hpp"
+#include "driver_input.hpp"
+#include "screen_buffer.hpp"
+#include "field_map.hpp"
+#include "benchmark.hpp"
+#include "predictive_exit.hpp"
+#include "interference.hpp"
+#include "executive.hpp"
+#include "sampler.hpp"
+#include "latency.hpp"
+#include "route.hpp"
+#include "route_bytecode.hpp"
+#include "telemetry.hpp"
+#include "profiler.hpp"
 
 
 /**
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "EZ-Template/api.hpp"
+#include "api.h"
+
+/**
+ * Callbacks that fire part way through a motion.
+ *
+ * Start a motion, attach events to it, then wait on the motion like normal.  The
+ * events task checks every event each tick, so they fire within 10ms of their
+ * trigger without the auton waiting on them.  Distance, angle and time are measured
+ * from when the event is attached.  Events fire once.
+ *
+ * Each event belongs to the motion that was running when it was attached, and
+ * any that haven't fired are dropped once another motion starts or the drive is
+ * disabled.  When pursuit or a profiled motion hands its last stretch to
+ * EZ-Template, that's still the same motion.  A motion starting is seen as the
+ * drive mode or a drive, turn or swing target changing, so back to back odom
+ * motions in the same mode look like one motion.
+ */
+class motion_events {
+ public:
+  /**
+   * Max events that can be armed at once.
+   */
+  static const int MAX_EVENTS = 16;
+
+  /**
+   * Enum for what triggers an event.
+   */
+  enum e_trigger { DISTANCE = 0,
+                   INDEX = 1,
+                   REGION = 2,
+                   ANGLE = 3,
+                   TIME = 4 };
+
+  motion_events();
+
+  /**
+   * Fires once the robot has traveled this far, forwards or backwards.
+   *
+   * \param p_distance
+   *        an okapi distance unit
+   * \param callback
+   *        function to run
+   */
+  bool at_distance(okapi::QLength p_distance, std::function<void()> callback);
+
+  /**
+   * Fires once pure pursuit passes the movement at this index.
+   *
+   * \param index
+   *        index of the movement given to pursuit.pid_pursuit_set()
+   * \param callback
+   *        function to run
+   */
+  bool at_index(int index, std::function<void()> callback);
+
+  /**
+   * Fires once the robot is within a radius of a point.
+   *
+   * \param center
+   *        center of the region
+   * \param p_radius
+   *        an okapi distance unit
+   * \param callback
+   *        function to run
+   */
+  bool in_region(ez::united_pose center, okapi::QLength p_radius, std::function<void()> callback);
+
+  /**
+   * Fires once the robot's heading reaches or crosses an angle.
+   *
+   * \param p_angle
+   *        an okapi angle unit, compared against chassis.drive_imu_get()
+   * \param callback
+   *        function to run
+   */
+  bool at_angle(okapi::QAngle p_angle, std::function<void()> callback);
+
+  /**
+   * Fires once this much time has passed.
+   *
+   * \param p_time
+   *        an okapi time unit
+   * \param callback
+   *        function to run
+   */
+  bool at_time(okapi::QTime p_time, std::function<void()> callback);
+
+  /**
+   * Removes every armed event.  This is called at the start of autonomous() and opcontrol().
+   */
+  void clear();
+
+  /**
+   * Returns how many events are armed.
+   */
+  int armed();
+
+  /**
+   * Checks every event and fires the ones that triggered.  This is called by the events task.
+   */
+  void iterate();
+
+ private:
+  struct event {
+    e_trigger trigger;
+    double value = 0.0;
+    ez::pose point = {0.0, 0.0, 0.0};
+    double start = 0.0;
+    double last_error = 0.0;
+    std::function<void()> callback;
+  };
+
+  /**
+   * What's driving the robot, a change is a new motion.
+   */
+  struct motion_key {
+    int mode;
+    int followers;
+    int path_version;
+    double targets[4];
+    bool operator==(const motion_key& other) const;
+  };
+
+  event list[MAX_EVENTS];
+  int count = 0;
+  motion_key last_key = {};
+  double traveled = 0.0;
+  ez::pose last_pose = {0.0, 0.0, 0.0};
+  pros::Mutex events_lock;
+
+  motion_key key_get();
+  void motion_update();
+  bool add(event input);
+  bool triggered(event& input, ez::pose current, double heading, int now);
+};
+
+/**
+ * Global motion events.
+ */
+extern motion_events events;
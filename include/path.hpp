@@ -0,0 +1,130 @@
+#pragma once
+
+#include <memory>
+
+#include "EZ-Template/api.hpp"
+#include "api.h"
+
+/**
+ * Compact path used by the odom motion code.
+ *
+ * Every field is stored in its own array so the per-tick searches only touch the
+ * x and y arrays.  Storage is allocated once at construction and never grows, and
+ * the path can be moved but not copied so it's never duplicated by accident.
+ */
+class path_buffer {
+ public:
+  /**
+   * Allocates storage for a path.
+   *
+   * \param capacity
+   *        the most points this path can hold
+   */
+  explicit path_buffer(int capacity = 2048);
+
+  path_buffer(path_buffer&&) = default;
+  path_buffer& operator=(path_buffer&&) = default;
+  path_buffer(const path_buffer&) = delete;
+  path_buffer& operator=(const path_buffer&) = delete;
+
+  /**
+   * Removes every point without freeing storage.
+   */
+  void clear();
+
+  /**
+   * Adds a point to the end of the path.  Returns false if the path is full.
+   *
+   * \param point
+   *        an odom movement
+   */
+  bool push_back(const ez::odom& point);
+
+  /**
+   * Returns the number of points in the path.
+   */
+  int size() const;
+
+  /**
+   * Returns the most points this path can hold.
+   */
+  int capacity() const;
+
+  /**
+   * Returns true if the path has no points.
+   */
+  bool empty() const;
+
+  /**
+   * Returns the distance from a point on the path to a pose.
+   *
+   * \param index
+   *        point on the path
+   * \param current
+   *        pose to measure to
+   */
+  float distance_to(int index, ez::pose current) const;
+
+  /**
+   * Returns the distance between two points on the path.
+   *
+   * \param a
+   *        point on the path
+   * \param b
+   *        point on the path
+   */
+  float distance_between(int a, int b) const;
+
+  /**
+   * Returns a point on the path as a pose.
+   *
+   * \param index
+   *        point on the path
+   */
+  ez::pose pose_get(int index) const;
+
+  /**
+   * Returns a point on the path as an odom movement.
+   *
+   * \param index
+   *        point on the path
+   */
+  ez::odom odom_get(int index) const;
+
+  /**
+   * Returns the whole path as odom movements.  This allocates, so keep it out of loops.
+   */
+  std::vector<ez::odom> odoms_get() const;
+
+  /**
+   * Smooths the path in place.
+   *
+   * This gives the same shape gradient descent smoothing settles on, but solves for
+   * it directly so the cost only depends on the number of points.  The first and
+   * last points, and points where the direction changes, don't move.
+   *
+   * \param weight_smooth
+   *        how much each point is pulled towards its neighbors
+   * \param weight_data
+   *        how much each point is pulled towards where it started
+   */
+  void smooth(double weight_smooth, double weight_data);
+
+  /**
+   * Path arrays.  speed and look_ahead are filled in by whatever profiles the path.
+   */
+  std::unique_ptr<float[]> x;
+  std::unique_ptr<float[]> y;
+  std::unique_ptr<float[]> theta;
+  std::unique_ptr<float[]> speed;
+  std::unique_ptr<float[]> look_ahead;
+  std::unique_ptr<std::int16_t[]> max_speed;
+  std::unique_ptr<std::uint8_t[]> direction;
+  std::unique_ptr<std::uint8_t[]> turn_behavior;
+
+ private:
+  std::unique_ptr<float[]> scratch;
+  int count = 0;
+  int max_count = 0;
+  void smooth_segment(float* axis, int start, int end, double weight_smooth, double weight_data);
+};
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "EZ-Template/api.hpp"
+#include "api.h"
+
+/**
+ * Exits a motion as soon as it can be predicted to come to rest inside tolerance.
+ *
+ * The normal exit conditions wait a fixed time once the error is small.  This
+ * fits the last few errors to a second order model, e[n+1] = a1 e[n] + a2 e[n-1] + c,
+ * which is what a PD loop driving a motor looks like from one tick to the next.
+ * Where that model comes to rest is c / (1 - a1 - a2).  The motion exits once
+ * that rest point, widened by how badly the model fits, is inside the motion's
+ * small_error for a few ticks in a row.
+ *
+ * The normal exit conditions still run alongside it, so a motion that can't be
+ * predicted exits the same way it always did.
+ */
+class predictive_exit {
+ public:
+  /**
+   * Most errors the model can be fit to.
+   */
+  static const int MAX_WINDOW = 32;
+
+  predictive_exit();
+
+  /**
+   * Blocks until the current drive, turn, swing or odom motion is predicted to settle, or exits normally.
+   *
+   * Pure pursuit has no single error to predict, so it waits with chassis.pid_wait().
+   */
+  void pid_wait();
+
+  /**
+   * Forgets every error, call this before predicting a new motion.
+   */
+  void reset();
+
+  /**
+   * Adds an error and returns true once the motion is predicted to come to rest inside tolerance.
+   *
+   * \param error
+   *        error this tick
+   * \param tolerance
+   *        largest error at rest that counts as settled
+   */
+  bool update(double error, double tolerance);
+
+  /**
+   * Returns the error the motion is predicted to come to rest at, NAN when there's no prediction.
+   */
+  double prediction_get();
+
+  /**
+   * Returns how far the prediction could be off, from how badly the model fits.
+   */
+  double uncertainty_get();
+
+  /**
+   * Sets how the prediction is made.
+   *
+   * \param window
+   *        errors the model is fit to, 6 to MAX_WINDOW
+   * \param confidence
+   *        how many times the fit's RMS error is added to the prediction before checking tolerance
+   * \param confirm
+   *        ticks in a row the prediction has to be inside tolerance
+   */
+  void constants_set(int window, double confidence, int confirm);
+
+  /**
+   * Returns the window, confidence and confirm ticks.
+   */
+  std::vector<double> constants_get();
+
+  /**
+   * Returns how long the last pid_wait() took, in ms.
+   */
+  int settle_time_get();
+
+  /**
+   * Returns true if the last pid_wait() exited on a prediction instead of the normal exit conditions.
+   */
+  bool predicted();
+
+  /**
+   * Checks the normal exit conditions for a motion, the same ones chassis.pid_wait() uses.  Returns true once it's exited.
+   *
+   * \param mode
+   *        the drive mode the motion is running in
+   * \param print
+   *        true prints the exit
+   */
+  bool exit_condition(ez::e_mode mode, bool print = false);
+
+ private:
+  int WINDOW = 12;
+  double CONFIDENCE = 3.0;
+  int CONFIRM = 3;
+
+  double errors[MAX_WINDOW];
+  int head = 0;
+  int count = 0;
+  int confirmed = 0;
+  double prediction = NAN;
+  double uncertainty = NAN;
+  int settle_time = 0;
+  bool last_predicted = false;
+
+  double at(int age);
+  bool fit(int terms);
+  double error_get(ez::e_mode mode);
+  double exit_error_get(ez::e_mode mode, bool big);
+};
+
+/**
+ * Global predictive exit.
+ */
+extern predictive_exit predict;
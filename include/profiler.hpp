@@ -0,0 +1,124 @@
+#pragma once
+
+#include "EZ-Template/api.hpp"
+#include "api.h"
+
+/**
+ * How much CPU time and stack every task is using.
+ *
+ * Once a window the FreeRTOS scheduler is asked for every task's run time and
+ * the least stack it has ever had free.  CPU is the share of the window each
+ * task ran for, and load is everything but the idle task.  A task that's close
+ * to running out of stack shows up before it crashes the brain, and one with
+ * lots left over can be given a smaller stack.
+ *
+ * Tasks are kept by name, so the competition tasks PROS makes again every time
+ * the robot is enabled stay in the same slot.
+ */
+class task_profiler {
+ public:
+  static const int MAX_TASKS = 48;
+  static const int NAME_SIZE = 24;
+
+  /**
+   * One task, as of the last window.
+   */
+  struct task_stats {
+    char name[NAME_SIZE];
+    void* handle;
+    int priority;
+    std::uint32_t runtime;
+    double cpu;
+    int stack_free;
+    bool alive;
+  };
+
+  task_profiler();
+
+  /**
+   * Sets how long CPU use is averaged over.
+   *
+   * \param p_window
+   *        an okapi time unit
+   */
+  void window_set(okapi::QTime p_window);
+
+  /**
+   * Returns true if the kernel has task stats and they look like what the profiler expects.
+   * Without them nothing is measured.
+   */
+  bool available();
+
+  /**
+   * Returns true if the kernel keeps run time for each task.  Without it only stack is measured.
+   */
+  bool runtime_available();
+
+  /**
+   * Returns the percent of CPU time that wasn't idle over the last window.
+   */
+  double load_get();
+
+  /**
+   * Returns how many tasks have been seen.
+   */
+  int size();
+
+  /**
+   * Returns a task, busiest first.
+   *
+   * \param index
+   *        0 is the busiest
+   */
+  task_stats get(int index);
+
+  /**
+   * Returns a task by name.  The name is empty if there isn't one.
+   */
+  task_stats find(std::string name);
+
+  /**
+   * Returns the least stack any running task has had free, in bytes.
+   */
+  int stack_free_min();
+
+  /**
+   * Prints every task to the terminal.
+   */
+  void print();
+
+  /**
+   * Adds a telemetry channel for every task as it's found, with its CPU and stack free.
+   *
+   * \param p_rate
+   *        an okapi time unit, how often each is sent
+   */
+  void telemetry_add(okapi::QTime p_rate);
+
+  /**
+   * Measures every task once a window.  This is called by the profiler task.
+   */
+  void iterate();
+
+ private:
+  int WINDOW = 1000;
+
+  task_stats tasks[MAX_TASKS];
+  int order[MAX_TASKS];
+  int count = 0;
+  double load = 0.0;
+  bool has_runtime = false;
+  bool layout_ok = true;
+  std::uint32_t last_total = 0;
+  std::uint32_t last_sample = 0;
+  int telemetry_rate = 0;
+  pros::Mutex profiler_lock;
+
+  int slot(const char* name);
+  void sample();
+};
+
+/**
+ * Global task profiler.
+ */
+extern task_profiler profiler;
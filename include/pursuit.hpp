@@ -0,0 +1,318 @@
+#pragma once
+
+#include "EZ-Template/api.hpp"
+#include "api.h"
+#include "path.hpp"
+
+/**
+ * Pure pursuit follower that runs alongside EZ-Template.
+ *
+ * The path is injected with points every spacing inches into a path_buffer, and
+ * optionally smoothed.  Each tick the closest point and the look ahead point are
+ * searched for in a window that only moves forward, so the cost per tick doesn't
+ * grow with the length of the path.  If the robot gets pushed off the path, a
+ * coarse grid of the path is used to find where to rejoin it.
+ *
+ * Once the robot is close to the end of the path, the final point is handed to
+ * chassis.pid_odom_set() so EZ-Template settles the motion like any other.  Points
+ * with an angle get an extra point injected behind them, the same as a boomerang
+ * carrot, so the robot arrives facing that angle.  Legs can be chained with
+ * pid_wait_quick_chain() so the robot doesn't stop between them.
+ *
+ * Each injected point gets a speed limited by the curvature of the path there and
+ * ramped down ahead of bends, and a look ahead that shrinks in bends.  The look
+ * ahead used each tick grows from the minimum to that point's look ahead as the
+ * robot speeds up.
+ */
+class pure_pursuit {
+ public:
+  /**
+   * \param capacity
+   *        the most points an injected path can hold, longer paths are spaced further apart
+   */
+  explicit pure_pursuit(int capacity = 2048);
+
+  /**
+   * Starts following a path from the robot's current position.  A path with more
+   * movements than the path buffer has points is handed to chassis.pid_odom_set() instead.
+   *
+   * \param imovements
+   *        a vector of odom movements, the same as chassis.pid_odom_set()
+   */
+  void pid_pursuit_set(const std::vector<ez::odom>& imovements);
+
+  /**
+   * Starts following a path from the robot's current position.
+   *
+   * \param p_imovements
+   *        a vector of united odom movements, the same as chassis.pid_odom_set()
+   */
+  void pid_pursuit_set(const std::vector<ez::united_odom>& p_imovements);
+
+  /**
+   * Starts driving to a single point from the robot's current position.
+   *
+   * \param p_imovement
+   *        a united odom movement, the same as chassis.pid_odom_set()
+   */
+  void pid_pursuit_set(const ez::united_odom& p_imovement);
+
+  /**
+   * Blocks until the path is done and EZ-Template has settled the last point.
+   */
+  void pid_wait();
+
+  /**
+   * Blocks until the robot is within the chain radius of the end of the path, and
+   * leaves it driving so the next pid_pursuit_set() picks up at speed.
+   *
+   * Your final motion should still use pid_wait().
+   */
+  void pid_wait_quick_chain();
+
+  /**
+   * Sets how close to the end of a path pid_wait_quick_chain() returns.
+   *
+   * \param p_radius
+   *        an okapi distance unit
+   */
+  void chain_radius_set(okapi::QLength p_radius);
+
+  /**
+   * Returns how close to the end of a path pid_wait_quick_chain() returns, in inches.
+   */
+  double chain_radius_get();
+
+  /**
+   * Blocks until the robot has passed the original movement at this index.
+   *
+   * \param index
+   *        index of the movement given to pid_pursuit_set()
+   */
+  void pid_wait_until_index(int index);
+
+  /**
+   * Stops following the path and stops the drive.
+   */
+  void stop();
+
+  /**
+   * Returns true while the path is being followed.
+   */
+  bool enabled();
+
+  /**
+   * Sets how far ahead on the path the robot looks.
+   *
+   * \param p_distance
+   *        an okapi distance unit
+   */
+  void look_ahead_set(okapi::QLength p_distance);
+
+  /**
+   * Sets the range the look ahead adapts within.
+   *
+   * The minimum is used when the robot is stopped, the maximum on straights at full speed.
+   *
+   * \param p_min
+   *        an okapi distance unit
+   * \param p_max
+   *        an okapi distance unit
+   */
+  void look_ahead_set(okapi::QLength p_min, okapi::QLength p_max);
+
+  /**
+   * Returns the look ahead used on the last tick, in inches.
+   */
+  double look_ahead_get();
+
+  /**
+   * Returns the minimum and maximum look ahead, in inches.
+   */
+  std::vector<double> look_ahead_range_get();
+
+  /**
+   * Sets how fast the robot can go through a bend.
+   *
+   * Speed through a point is limited to this constant times the radius of the path there.
+   *
+   * \param constant
+   *        speed (0 - 127) per inch of radius
+   */
+  void curve_speed_constant_set(double constant);
+
+  /**
+   * Returns how fast the robot can go through a bend, speed per inch of radius.
+   */
+  double curve_speed_constant_get();
+
+  /**
+   * Sets how quickly speed ramps down ahead of a bend.
+   *
+   * \param speed_per_inch
+   *        speed (0 - 127) lost per inch of travel
+   */
+  void curve_decel_set(double speed_per_inch);
+
+  /**
+   * Returns how quickly speed ramps down ahead of a bend, speed per inch.
+   */
+  double curve_decel_get();
+
+  /**
+   * Sets how much the injected path is smoothed.  0 weight_smooth disables smoothing.
+   *
+   * \param weight_smooth
+   *        how much each point is pulled towards its neighbors
+   * \param weight_data
+   *        how much each point is pulled towards where it was injected
+   */
+  void smooth_constants_set(double weight_smooth, double weight_data);
+
+  /**
+   * Returns the smoothing constants, {weight_smooth, weight_data}.
+   */
+  std::vector<double> smooth_constants_get();
+
+  /**
+   * Sets the speed of the robot at full power, used to scale the look ahead with velocity.
+   *
+   * \param in_per_sec
+   *        inches per second
+   */
+  void velocity_max_set(double in_per_sec);
+
+  /**
+   * Returns the speed of the robot at full power, in inches per second.
+   */
+  double velocity_max_get();
+
+  /**
+   * Returns the speed of the robot measured from odom, in inches per second.
+   */
+  double velocity_get();
+
+  /**
+   * Sets the spacing between injected points.
+   *
+   * \param p_spacing
+   *        an okapi distance unit
+   */
+  void spacing_set(okapi::QLength p_spacing);
+
+  /**
+   * Returns the spacing between injected points, in inches.
+   */
+  double spacing_get();
+
+  /**
+   * Sets how many points past the last closest point are searched each tick.
+   *
+   * \param points
+   *        number of injected points
+   */
+  void window_set(int points);
+
+  /**
+   * Returns how many points past the last closest point are searched each tick.
+   */
+  int window_get();
+
+  /**
+   * Sets how far the robot can be from the path before the grid is used to rejoin it.
+   *
+   * \param p_distance
+   *        an okapi distance unit
+   */
+  void rejoin_distance_set(okapi::QLength p_distance);
+
+  /**
+   * Returns how far the robot can be from the path before the grid is used to rejoin it, in inches.
+   */
+  double rejoin_distance_get();
+
+  /**
+   * Returns the index of the injected point closest to the robot.
+   */
+  int closest_index_get();
+
+  /**
+   * Returns the index of the last movement given to pid_pursuit_set() that the robot has passed, -1 if none.
+   */
+  int movement_index_get();
+
+  /**
+   * Returns the index of the injected point the robot is steering towards.
+   *
+   * \param current
+   *        current robot pose
+   */
+  int look_ahead_index_find(ez::pose current);
+
+  /**
+   * Returns a copy of the injected path as odom movements.
+   */
+  std::vector<ez::odom> path_get();
+
+  /**
+   * Returns the injected path without copying it.
+   */
+  const path_buffer& path_buffer_get();
+
+  /**
+   * Returns a number that changes every time a new path is started.
+   */
+  int path_version_get();
+
+  /**
+   * Runs one iteration of the follower.  This is called by the pursuit task.
+   */
+  void iterate();
+
+ private:
+  path_buffer path;
+  std::vector<int> injected_index;
+  int closest_index = 0;
+  int look_ahead_index = 0;
+  bool running = false;
+  bool chain_pending = false;
+  int path_version = 0;
+  double CHAIN_RADIUS = 4.0;
+  pros::Mutex path_lock;
+
+  double LOOK_AHEAD = 7.0;
+  double LOOK_AHEAD_MIN = 7.0;
+  double LOOK_AHEAD_MAX = 7.0;
+  double CURVE_SPEED = 5.0;
+  double CURVE_DECEL = 4.0;
+  double SMOOTH_WEIGHT = 0.0;
+  double SMOOTH_DATA = 0.0;
+  double VELOCITY_MAX = 65.0;
+  double velocity = 0.0;
+  ez::pose last_pose = {0.0, 0.0, 0.0};
+  int last_time = 0;
+  double SPACING = 0.5;
+  int WINDOW = 40;
+  double REJOIN_DISTANCE = 6.0;
+
+  /**
+   * Coarse grid of the path, sorted by cell, used to rejoin after a disturbance.
+   */
+  const double GRID_SIZE = 6.0;
+  std::vector<std::pair<int, int>> grid;
+  int grid_cell(double x, double y);
+  void grid_build();
+  int grid_rejoin(ez::pose current);
+
+  ez::pose carrot_get(const ez::odom& movement, ez::pose from);
+  bool inject(const std::vector<ez::odom>& imovements);
+  void profile();
+  double radius_at(int index, int span);
+  void velocity_update(ez::pose current);
+  void closest_index_update(ez::pose current);
+};
+
+/**
+ * Global pure pursuit follower.
+ */
+extern pure_pursuit pursuit;
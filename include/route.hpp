@@ -0,0 +1,122 @@
+#pragma once
+
+#include "EZ-Template/api.hpp"
+#include "api.h"
+
+/**
+ * An auton split into named segments, any of which can be run on its own.
+ *
+ * Each segment knows the pose the robot is in when it starts.  Running the
+ * route from a segment sets odom to that pose and runs from there to the end,
+ * so the last part of a long routine can be practiced without driving the
+ * rest of it first.  Running the whole route never touches odom between
+ * segments, so it drives exactly the same as one long function.
+ *
+ * tools/route_segments.cpp runs the skills route in src/skills.cpp on a
+ * computer and checks that each segment's start pose is where the segments
+ * before it leave the robot.
+ */
+class route {
+ public:
+  /**
+   * One leg of a route.
+   */
+  struct segment {
+    /**
+     * A segment that starts at a known pose.
+     *
+     * \param p_name
+     *        name shown in the selector
+     * \param p_start
+     *        pose the robot is in when the segment starts
+     * \param p_body
+     *        runs the segment
+     */
+    segment(const char* p_name, ez::united_pose p_start, std::function<void()> p_body);
+
+    /**
+     * A segment that sets odom itself, like one that lines up with a distance sensor.
+     *
+     * \param p_name
+     *        name shown in the selector
+     * \param p_body
+     *        runs the segment
+     */
+    segment(const char* p_name, std::function<void()> p_body);
+
+    const char* name;
+    bool has_start;
+    ez::united_pose start;
+    std::function<void()> body;
+  };
+
+  /**
+   * \param p_name
+   *        name of the route, shown in the selector
+   * \param p_segments
+   *        segments in the order they run
+   */
+  route(const char* p_name, std::vector<segment> p_segments);
+
+  /**
+   * Runs every segment from the start.
+   */
+  void run();
+
+  /**
+   * Sets odom to a segment's start pose and runs it and everything after it.
+   *
+   * \param index
+   *        segment to start at
+   */
+  void run_from(int index);
+
+  /**
+   * Sets odom to a segment's start pose and runs only that segment.
+   *
+   * \param index
+   *        segment to run
+   */
+  void run_segment(int index);
+
+  /**
+   * Returns how many segments there are.
+   */
+  int size();
+
+  /**
+   * Returns a segment's name.
+   */
+  std::string name_get(int index);
+
+  /**
+   * Returns true if a segment has a start pose, false if it sets odom itself.
+   */
+  bool start_known(int index);
+
+  /**
+   * Returns a segment's start pose.
+   */
+  ez::united_pose start_get(int index);
+
+  /**
+   * Sets a function that's run as each segment starts, given its index.  Use it to log or check where segments start.
+   *
+   * \param callback
+   *        function to run, nullptr for none
+   */
+  void segment_callback_set(std::function<void(int)> callback);
+
+  /**
+   * Returns a selector page for every segment after the first, each running the route from that segment.
+   */
+  std::vector<ez::Auton> autons_get();
+
+ private:
+  const char* name;
+  std::vector<segment> segments;
+  std::function<void(int)> segment_callback = nullptr;
+
+  void start(int index);
+  void run_range(int from, int to);
+};
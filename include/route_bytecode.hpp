@@ -0,0 +1,60 @@
+#pragma once
+
+#include "EZ-Template/api.hpp"
+#include "api.h"
+#include "route_format.hpp"
+
+/**
+ * Runs a compiled route off the SD card.
+ *
+ * Coordinates, speeds, exit conditions and actuator timing all live in the
+ * route file, so changing them is copying a new file onto the SD card instead
+ * of building and uploading.  tools/route_compiler.cpp turns a text route into
+ * the file and checks it first.  The file is read once in initialize() into a
+ * buffer that's allocated with the rest of the program, checked again, and then
+ * run instruction by instruction on the same chassis calls autons.cpp uses.
+ */
+class route_bytecode {
+ public:
+  route_bytecode();
+
+  /**
+   * Reads and checks a route file.  Returns true if it can be run.
+   *
+   * \param file
+   *        path to the file, like "/usd/route.bin"
+   */
+  bool load(std::string file);
+
+  /**
+   * Returns true if a route is loaded.
+   */
+  bool loaded();
+
+  /**
+   * Returns how many instructions the loaded route has.
+   */
+  int size();
+
+  /**
+   * Runs the loaded route, does nothing if there isn't one.
+   */
+  void run();
+
+ private:
+  std::uint8_t buffer[route_format::MAX_BYTES];
+  int bytes = 0;
+  int count = 0;
+  bool is_loaded = false;
+  std::vector<ez::odom> path;
+
+  bool check();
+  bool angles_set(std::uint8_t op, int offset);
+  int decode(int offset, double* args);
+  void execute(std::uint8_t op, double* args);
+};
+
+/**
+ * Global SD card route.
+ */
+extern route_bytecode sd_route;
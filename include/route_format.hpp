@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+// This header is shared with tools/route_compiler.cpp, so it can't include anything from PROS
+
+/**
+ * Layout of a compiled route file, what the route compiler writes and sd_route runs.
+ *
+ *   header: "EZRT", uint8 version, uint8 unused, uint16 instructions, uint32 payload bytes, uint32 payload checksum
+ *   payload: one instruction after another, an opcode then its arguments
+ *
+ * Instructions aren't all the same size, each is as long as its opcode's
+ * arguments add up to, so op_size() is how a reader steps to the next one.
+ *
+ * Every argument is one of these, all little endian:
+ *   d  int16   distance in hundredths of an inch
+ *   a  int16   angle in tenths of a degree, NO_ANGLE where the pose has no heading
+ *   s  int8    speed or motor power, -127 to 127
+ *   t  uint16  time in ms
+ *   f  uint8   flag, direction, swing side or actuator number
+ */
+namespace route_format {
+const char MAGIC[4] = {'E', 'Z', 'R', 'T'};
+const std::uint8_t VERSION = 1;
+const int HEADER_SIZE = 16;
+const int MAX_ARGS = 6;
+const int MAX_BYTES = 4096;  // Biggest route file the robot's buffer holds
+const int MAX_PATH = 32;     // Most points a path can have before it's run
+const double DISTANCE_SCALE = 100.0;
+const double ANGLE_SCALE = 10.0;
+const std::int16_t NO_ANGLE = INT16_MIN;
+
+enum e_op : std::uint8_t {
+  END = 0,
+  POSE,        // x, y, theta                        odom_xyt_set
+  DRIVE,       // distance, speed, slew               pid_drive_set
+  ODOM_DRIVE,  // distance, speed, slew               pid_odom_set
+  TURN,        // angle, speed                        pid_turn_set
+  SWING,       // side, angle, speed, opposite speed  pid_swing_set
+  POINT,       // x, y, theta, reverse, speed, slew   pid_odom_set to one point
+  PATH_POINT,  // x, y, theta, reverse, speed         adds a point to the path
+  PATH_RUN,    // slew                                pid_odom_set through the path, then clears it
+  WAIT,        //                                     pid_wait
+  WAIT_QUICK,  //                                     pid_wait_quick
+  WAIT_CHAIN,  //                                     pid_wait_quick_chain
+  WAIT_UNTIL,  // distance                            pid_wait_until
+  DELAY,       // time                                pros::delay
+  DRIVE_EXIT,  // small time, small error, big time, big error, velocity time, current time
+  TURN_EXIT,   // same, errors are angles
+  SWING_EXIT,  // same, errors are angles
+  ODOM_EXIT,   // same, errors are distances
+  MOTOR,       // motor, power                        move
+  PISTON,      // piston, extended                    set
+  OP_COUNT
+};
+
+/**
+ * What an opcode is called in a text route, and the arguments it takes.
+ */
+struct op_info {
+  const char* name;
+  const char* args;
+};
+
+const op_info OPS[OP_COUNT] = {
+    {"end", ""},
+    {"pose", "dda"},
+    {"drive", "dsf"},
+    {"odom_drive", "dsf"},
+    {"turn", "as"},
+    {"swing", "fass"},
+    {"point", "ddafsf"},
+    {"path_point", "ddafs"},
+    {"path_run", "f"},
+    {"wait", ""},
+    {"wait_quick", ""},
+    {"wait_chain", ""},
+    {"wait_until", "d"},
+    {"delay", "t"},
+    {"drive_exit", "tdtdtt"},
+    {"turn_exit", "tatatt"},
+    {"swing_exit", "tatatt"},
+    {"odom_exit", "tdtdtt"},
+    {"motor", "fs"},
+    {"piston", "ff"},
+};
+
+// Actuators a route can use, by the number it stores.  Keep these in the same order as the tables in route_bytecode.cpp
+const char* const MOTORS[] = {"intake", "topintake", "backintake"};
+const char* const PISTONS[] = {"matchload", "descore", "med", "small"};
+const int MOTOR_COUNT = sizeof(MOTORS) / sizeof(MOTORS[0]);
+const int PISTON_COUNT = sizeof(PISTONS) / sizeof(PISTONS[0]);
+
+/**
+ * Returns how many bytes an argument takes.
+ */
+inline int arg_size(char type) { return type == 's' || type == 'f' ? 1 : 2; }
+
+/**
+ * Returns true if an opcode's angle can be NO_ANGLE, written "-" in a text route.  Only
+ * points can leave their heading out, everything else needs a real angle.
+ */
+inline bool angle_optional(std::uint8_t op) { return op == POINT || op == PATH_POINT; }
+
+/**
+ * Returns how many bytes an instruction takes, opcode included.
+ */
+inline int op_size(std::uint8_t op) {
+  int size = 1;
+  for (const char* type = OPS[op].args; *type; type++)
+    size += arg_size(*type);
+  return size;
+}
+
+/**
+ * FNV-1a over the payload, a bad copy to the SD card fails this instead of driving.
+ */
+inline std::uint32_t checksum(const std::uint8_t* data, int size) {
+  std::uint32_t hash = 2166136261u;
+  for (int i = 0; i < size; i++)
+    hash = (hash ^ data[i]) * 16777619u;
+  return hash;
+}
+}  // namespace route_format
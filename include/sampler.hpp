@@ -0,0 +1,145 @@
+#pragma once
+
+#include "EZ-Template/api.hpp"
+#include "api.h"
+
+/**
+ * Timestamps sensor readings, so velocities are worked out over the time that actually passed between them.
+ *
+ * V5 devices send new data at their own rates.  Reading one every tick
+ * sometimes gets the same sample twice and sometimes skips one, so a derivative
+ * over a fixed 10ms is zero one tick and doubled the next.  The sampler polls
+ * every channel each millisecond and only keeps a reading when it's a new sample.
+ * Motors say when their encoder was read.  Everything else counts as new when
+ * its value changes, or once a full data period has passed with the same value,
+ * which is a sensor sitting still.
+ *
+ * A channel is stale once nothing new has come in for a few data periods, or
+ * the device stops answering.
+ */
+class sensor_sampler {
+ public:
+  /**
+   * Most channels that can be added.
+   */
+  static const int MAX_CHANNELS = 12;
+
+  /**
+   * The newest sample on a channel.
+   */
+  struct sample {
+    double value;
+    double velocity;
+    double dt;
+    std::uint64_t time;
+    std::uint32_t sequence;
+    bool stale;
+  };
+
+  sensor_sampler();
+
+  /**
+   * Adds a motor's position.  Motors timestamp their own samples.  Returns the channel, or -1 if there's no room.
+   *
+   * \param motor
+   *        the motor
+   * \param name
+   *        name for print()
+   * \param scale
+   *        multiplied into get_position(), ie 1 / chassis.drive_tick_per_inch() for inches
+   */
+  int motor_add(pros::Motor motor, const char* name, double scale = 1.0);
+
+  /**
+   * Adds a rotation sensor's position and sets how often it sends data.  Returns the channel, or -1 if there's no room.
+   *
+   * \param sensor
+   *        the rotation sensor
+   * \param p_rate
+   *        data period, an okapi time unit, 5ms is the fastest
+   * \param name
+   *        name for print()
+   * \param scale
+   *        multiplied into get_position(), which is in centidegrees
+   */
+  int rotation_add(pros::Rotation sensor, okapi::QTime p_rate, const char* name, double scale = 1.0);
+
+  /**
+   * Adds anything else that can be read.  Returns the channel, or -1 if there's no room.
+   *
+   * \param read
+   *        returns the reading, PROS_ERR_F or INFINITY when the device isn't there
+   * \param p_rate
+   *        how often the device sends new data, an okapi time unit
+   * \param name
+   *        name for print()
+   */
+  int add(std::function<double()> read, okapi::QTime p_rate, const char* name);
+
+  /**
+   * Returns the newest sample on a channel.
+   *
+   * \param channel
+   *        returned when the channel was added
+   */
+  sample get(int channel);
+
+  /**
+   * Returns the newest value on a channel.
+   */
+  double value_get(int channel);
+
+  /**
+   * Returns the velocity between the two newest samples, in units per second.
+   */
+  double velocity_get(int channel);
+
+  /**
+   * Returns the time between the two newest samples, in seconds.
+   */
+  double dt_get(int channel);
+
+  /**
+   * Returns true if nothing new has come in for a few data periods, or the device stopped answering.
+   */
+  bool stale(int channel);
+
+  /**
+   * Returns how many polls got a sample that was already seen.
+   */
+  int duplicates_get(int channel);
+
+  /**
+   * Prints every channel's rate, newest sample and duplicates to the terminal.
+   */
+  void print();
+
+  /**
+   * Polls every channel.  This is called by the sampler task.
+   */
+  void iterate();
+
+ private:
+  struct channel_t {
+    const char* name;
+    std::function<double(std::uint32_t*)> read;
+    bool timestamped;
+    int rate;
+    std::uint32_t device_time;
+    sample newest;
+    int duplicates;
+  };
+
+  channel_t channels[MAX_CHANNELS];
+  int count = 0;
+  pros::Mutex sampler_lock;
+
+  int add(channel_t input);
+  void poll(channel_t& input, std::uint64_t now);
+  void store(channel_t& input, double value, std::uint64_t time);
+};
+
+/**
+ * Global sensor sampler.
+ */
+extern sensor_sampler sampler;
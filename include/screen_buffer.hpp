@@ -0,0 +1,85 @@
+#pragma once
+
+#include "EZ-Template/api.hpp"
+#include "api.h"
+
+/**
+ * Brain screen text that only redraws what changed.
+ *
+ * Lines are formatted into fixed buffers, so nothing is allocated, and compared
+ * against what's on the screen.  Only lines that changed are sent to the screen,
+ * and no more often than the refresh rate, so the screen task doesn't compete
+ * with the drive for CPU time.
+ */
+class screen_buffer {
+ public:
+  /**
+   * Lines on the brain screen.
+   */
+  static const int LINES = 8;
+
+  /**
+   * Most characters in a line, longer lines are cut off.
+   */
+  static const int WIDTH = 48;
+
+  screen_buffer();
+
+  /**
+   * Formats a line, like printf.  It's drawn on the next draw() if it changed.
+   *
+   * \param line
+   *        0 to 7
+   * \param format
+   *        printf style format
+   */
+  void print(int line, const char* format, ...) __attribute__((format(printf, 3, 4)));
+
+  /**
+   * Blanks a line.
+   *
+   * \param line
+   *        0 to 7
+   */
+  void clear(int line);
+
+  /**
+   * Forgets what's on the screen so every line is drawn again.  Use this after something else drew over the screen.
+   */
+  void invalidate();
+
+  /**
+   * Returns true once a refresh period has passed since the last draw.  Skip formatting when this is false.
+   */
+  bool due();
+
+  /**
+   * Sends every changed line to the screen.
+   */
+  void draw();
+
+  /**
+   * Sets how many times a second the screen can be drawn.
+   *
+   * \param hz
+   *        draws per second
+   */
+  void refresh_rate_set(double hz);
+
+  /**
+   * Returns how many times a second the screen can be drawn.
+   */
+  double refresh_rate_get();
+
+ private:
+  char pending[LINES][WIDTH + 1];
+  char drawn[LINES][WIDTH + 1];
+  bool dirty[LINES];
+  int period = 50;
+  int last_draw = 0;
+};
+
+/**
+ * Global brain screen.
+ */
+extern screen_buffer brain_screen;
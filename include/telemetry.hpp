@@ -0,0 +1,142 @@
+#pragma once
+
+#include "EZ-Template/api.hpp"
+#include "api.h"
+#include "pros/apix.h"
+#include "telemetry_format.hpp"
+
+/**
+ * Streams channels of numbers off the robot in binary frames.
+ *
+ * printf sends text a character at a time and blocks once the serial buffer is
+ * full, so printing every tick slows down whatever printed.  Here each channel
+ * is sampled at its own rate into a frame, and frames wait in a ring buffer
+ * until the port has room for them.  Nothing ever waits on the port.  When the
+ * buffer is full new frames are dropped and counted, so a slow link loses
+ * samples instead of slowing the robot down.
+ *
+ * tools/telemetry_decoder.cpp reads the stream on a computer and writes each
+ * channel to a CSV file.
+ */
+class telemetry_stream {
+ public:
+  static const int MAX_CHANNELS = 64;
+  static const int BUFFER_BYTES = 4096;
+
+  telemetry_stream();
+
+  /**
+   * Adds a channel.  Returns its number, or -1 if there's no room for it.
+   *
+   * \param name
+   *        name the decoder files it under
+   * \param values
+   *        names of the values split by commas, like "x,y,theta", at most 8
+   * \param read
+   *        fills in the values
+   * \param p_rate
+   *        an okapi time unit, how often it's sent.  0 adds it without sending it
+   */
+  int add(const char* name, const char* values, std::function<void(float*)> read, okapi::QTime p_rate = 0_ms);
+
+  /**
+   * Returns a channel's number, or -1 if there isn't one with that name.
+   */
+  int find(std::string name);
+
+  /**
+   * Starts sending a channel.
+   *
+   * \param name
+   *        channel name
+   * \param p_rate
+   *        an okapi time unit, how often it's sent
+   */
+  void subscribe(std::string name, okapi::QTime p_rate);
+
+  /**
+   * Stops sending a channel.
+   */
+  void unsubscribe(std::string name);
+
+  /**
+   * Sends over a smart port serial device instead of the USB port.
+   *
+   * \param port
+   *        smart port
+   * \param baud
+   *        baud rate
+   */
+  void serial_set(int port, int baud);
+
+  /**
+   * Sets how many bytes a second are written to the USB port, so its buffer never fills up and blocks.
+   * A smart port says how much room it has, so this isn't used there.
+   */
+  void bandwidth_set(int bytes_per_second);
+
+  /**
+   * Starts or stops streaming.  Streaming over USB turns off the PROS stream
+   * headers, so the port has to be read raw, not with the PROS terminal.
+   *
+   * \param input
+   *        true starts, false stops
+   */
+  void enable(bool input);
+
+  /**
+   * Returns true while streaming.
+   */
+  bool enabled();
+
+  /**
+   * Returns how many frames were dropped because the buffer was full.
+   */
+  int dropped_get();
+
+  /**
+   * Returns how many bytes are waiting to be sent.
+   */
+  int queued_get();
+
+  /**
+   * Samples every channel that's due and sends what the port has room for.  This is called by the telemetry task.
+   */
+  void iterate();
+
+ private:
+  struct channel_t {
+    const char* name;
+    const char* values;
+    int count;
+    int rate;
+    std::uint32_t next_send;
+    std::uint32_t next_describe;
+    std::function<void(float*)> read;
+  };
+
+  channel_t channels[MAX_CHANNELS];
+  int channel_count = 0;
+
+  std::uint8_t buffer[BUFFER_BYTES];
+  int head = 0;
+  int queued = 0;
+  int dropped = 0;
+
+  bool running = false;
+  int serial_port = 0;
+  int BANDWIDTH = 11520;
+  double allowance = 0.0;
+  std::uint32_t last_flush = 0;
+  pros::Mutex telemetry_lock;
+
+  void queue(const std::uint8_t* frame, int size);
+  void describe(int channel);
+  void sample(int channel, std::uint32_t now);
+  void flush();
+};
+
+/**
+ * Global telemetry stream.
+ */
+extern telemetry_stream telemetry;
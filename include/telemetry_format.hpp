@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+// This header is shared with tools/telemetry_decoder.cpp, so it can't include anything from PROS
+
+/**
+ * Framing for the binary telemetry stream.
+ *
+ * Every frame is COBS encoded, so it has no zero bytes in it, and has a zero on
+ * both sides of it.  Anything else on the same port, like a printf, ends up
+ * between two zeros on its own and fails the CRC instead of breaking a frame.
+ * Before encoding a frame is:
+ *
+ *   DATA      kind, uint8 channel, uint32 ms, uint8 count, count floats, crc
+ *   DESCRIBE  kind, uint8 channel, uint8 count, name, 0, value names split by commas, 0, crc
+ *
+ * all little endian.  Each channel is described every so often so a decoder
+ * that starts listening late learns what the channels are.
+ */
+namespace telemetry_format {
+const std::uint8_t DATA = 0;
+const std::uint8_t DESCRIBE = 1;
+const int MAX_VALUES = 8;
+const int MAX_FRAME = 96;  // Biggest frame before encoding
+const int MAX_ENCODED = MAX_FRAME + MAX_FRAME / 254 + 2;
+
+/**
+ * CRC-8, polynomial 0x07.
+ */
+inline std::uint8_t crc8(const std::uint8_t* data, int size) {
+  std::uint8_t crc = 0;
+  for (int i = 0; i < size; i++) {
+    crc ^= data[i];
+    for (int bit = 0; bit < 8; bit++)
+      crc = crc & 0x80 ? (crc << 1) ^ 0x07 : crc << 1;
+  }
+  return crc;
+}
+
+/**
+ * COBS encodes a frame and puts a zero on the end.  Returns the encoded size.
+ * output needs room for size + size / 254 + 2 bytes.
+ */
+inline int cobs_encode(const std::uint8_t* input, int size, std::uint8_t* output) {
+  int code_at = 0, out = 1;
+  std::uint8_t code = 1;
+  for (int i = 0; i < size; i++) {
+    if (input[i] != 0) {
+      output[out++] = input[i];
+      code++;
+    }
+    if (input[i] == 0 || code == 0xFF) {
+      output[code_at] = code;
+      code = 1;
+      code_at = out++;
+    }
+  }
+  output[code_at] = code;
+  output[out++] = 0;
+  return out;
+}
+
+/**
+ * Decodes one COBS frame, without its zero.  Returns the decoded size, or -1 if it isn't valid COBS.
+ */
+inline int cobs_decode(const std::uint8_t* input, int size, std::uint8_t* output, int capacity) {
+  int in = 0, out = 0;
+  while (in < size) {
+    std::uint8_t code = input[in++];
+    if (code == 0 || in + code - 1 > size) return -1;
+    for (int i = 1; i < code; i++) {
+      if (out >= capacity) return -1;
+      output[out++] = input[in++];
+    }
+    if (code != 0xFF && in < size) {
+      if (out >= capacity) return -1;
+      output[out++] = 0;
+    }
+  }
+  return out;
+}
+}  // namespace telemetry_format
@@ -0,0 +1,178 @@
+#pragma once
+
+#include "EZ-Template/api.hpp"
+#include "api.h"
+
+/**
+ * Temperature estimate for each motor, used to derate them before the firmware does.
+ *
+ * Each motor's temperature is modeled as heating with the square of its current
+ * and cooling towards the temperature it started at.  The motors only report
+ * temperature in coarse steps, so the estimate runs between readings and is only
+ * pulled back when it leaves the step the motor reports.
+ *
+ * From the estimate and the motor's recent current, the time until it reaches
+ * the firmware's derate temperature is predicted.  When that's inside the horizon
+ * the motor's current limit is brought down gradually, so it never hits the
+ * firmware's cut in power half way through a motion.
+ *
+ * Nothing is derated until it's enabled, and the constants should come from
+ * constants_measure() first.  Wrong constants take current away from motors
+ * that aren't hot.
+ */
+class thermal_model {
+ public:
+  /**
+   * Most motors that can be tracked.
+   */
+  static const int MAX_MOTORS = 12;
+
+  thermal_model();
+
+  /**
+   * Starts tracking a motor.  Returns false if it's already tracked or there's no room.
+   *
+   * \param motor
+   *        the motor
+   * \param name
+   *        name used to look the motor up
+   */
+  bool motor_add(pros::Motor motor, std::string name);
+
+  /**
+   * Starts tracking every drive motor.  The drive is derated as one through chassis.drive_current_limit_set().
+   */
+  void drive_add();
+
+  /**
+   * Enables or disables derating.  Disabling puts back the current limits from before it was enabled.
+   *
+   * \param input
+   *        true enables, false disables
+   */
+  void enable(bool input);
+
+  /**
+   * Returns true while motors are being derated.
+   */
+  bool enabled();
+
+  /**
+   * Sets the thermal model of the motors.
+   *
+   * \param heating
+   *        degrees C per second gained per amp squared
+   * \param cooling
+   *        fraction of the difference to the starting temperature lost per second
+   */
+  void constants_set(double heating, double cooling);
+
+  /**
+   * Returns the thermal model, {heating, cooling}.
+   */
+  std::vector<double> constants_get();
+
+  /**
+   * Heats a motor at full power, lets it cool, and fits the thermal model to the
+   * temperatures it reported.  Stall the motor, or load it hard, so it draws
+   * enough current to heat up.  Sets the constants, prints them and blocks until done.
+   *
+   * \param motor
+   *        the motor, it doesn't need to be tracked
+   * \param p_heat
+   *        an okapi time unit, how long to run it, it should heat at least 2 steps of 5C
+   * \param p_cool
+   *        an okapi time unit, how long to let it cool
+   */
+  void constants_measure(pros::Motor motor, okapi::QTime p_heat, okapi::QTime p_cool);
+
+  /**
+   * Sets when motors are derated.
+   *
+   * \param limit
+   *        temperature the firmware starts cutting power at, in degrees C
+   * \param p_horizon
+   *        motors predicted to reach the limit sooner than this get derated, an okapi time unit
+   * \param max_mA
+   *        current limit with no derating
+   * \param min_mA
+   *        the current limit never goes below this
+   */
+  void derate_set(double limit, okapi::QTime p_horizon, int max_mA, int min_mA);
+
+  /**
+   * Returns the estimated temperature of a motor in degrees C, 0 if it isn't tracked.
+   *
+   * \param name
+   *        name the motor was added with
+   */
+  double temperature_get(std::string name);
+
+  /**
+   * Returns the predicted seconds until a motor reaches the limit, infinity if it never will.
+   *
+   * \param name
+   *        name the motor was added with
+   */
+  double time_to_limit_get(std::string name);
+
+  /**
+   * Returns the current limit being applied to a motor in mA, 0 if it isn't tracked.
+   *
+   * \param name
+   *        name the motor was added with
+   */
+  int current_limit_get(std::string name);
+
+  /**
+   * Returns the current limit for the drive, the lowest of every drive motor's, in mA.  2500 while disabled.
+   */
+  int drive_current_limit_get();
+
+  /**
+   * Prints every motor's estimate, prediction and limit to the terminal.
+   */
+  void print();
+
+  /**
+   * Updates every estimate and current limit.  This is called by the thermal task.
+   */
+  void iterate();
+
+ private:
+  struct motor_state {
+    pros::Motor motor;
+    std::string name;
+    bool drive = false;
+    bool started = false;
+    double ambient = 0.0;
+    double temperature = 0.0;
+    double current = 0.0;
+    double time_to_limit = INFINITY;
+    double limit = 2500.0;
+    int applied_limit = 2500;
+    int saved_limit = 2500;
+  };
+
+  std::vector<motor_state> motors;
+  double HEATING = 0.08;
+  double COOLING = 0.004;
+  double LIMIT = 55.0;
+  double HORIZON = 20.0;
+  int MAX_MA = 2500;
+  int MIN_MA = 1000;
+  int last_time = 0;
+  int drive_applied_limit = 2500;
+  int drive_saved_limit = 2500;
+  bool running = false;
+  pros::Mutex thermal_lock;
+
+  bool add(pros::Motor motor, std::string name, bool drive);
+  motor_state* find(const std::string& name);
+  void update(motor_state& state, double dt);
+};
+
+/**
+ * Global motor thermal model.
+ */
+extern thermal_model thermal;
@@ -0,0 +1,200 @@
+#pragma once
+
+#include "EZ-Template/api.hpp"
+#include "api.h"
+
+/**
+ * Current limiting for the drive while pushing.
+ *
+ * While enabled, the drive's current limit is lowered when the motors run out of
+ * thermal headroom, when the wheels spin faster than the IMU says the robot is
+ * moving, and when the robot has stalled against something.  More current in
+ * any of those cases only heats the motors without adding pushing force.  The
+ * limit climbs back up once the wheels have grip again.
+ *
+ * Thermal headroom is tracked all the time, so it can be checked between motions.
+ *
+ * Ground speed comes from a tracking wheel parallel to the drive if one is set.
+ * Otherwise it's the IMU's acceleration integrated, and only pulled back onto
+ * the wheel speed while the motors draw too little current to be slipping.  A
+ * push never draws that little, so slip is only checked for a short time after
+ * the last time the IMU was pulled back, before its bias can add up to fake slip.
+ * Set a tracker to check slip for the whole push.
+ */
+class traction_control {
+ public:
+  /**
+   * Enum for which IMU axis points forwards.
+   */
+  enum e_axis { X_AXIS = 0,
+                Y_AXIS = 1 };
+
+  traction_control();
+
+  /**
+   * Starts a push with the current managed, the same as chassis.pid_drive_set().
+   *
+   * \param p_target
+   *        an okapi distance unit
+   * \param speed
+   *        0 to 127, max speed during motion
+   * \param slew_on
+   *        ramp up from a lower speed to your target speed
+   */
+  void pid_push_set(okapi::QLength p_target, int speed, bool slew_on = false);
+
+  /**
+   * Blocks until the push is done, then puts the drive's current limit back.
+   */
+  void pid_wait();
+
+  /**
+   * Enables or disables managing the drive's current.  Disabling puts back the limit from before it was enabled.
+   *
+   * \param input
+   *        true enables, false disables
+   */
+  void enable(bool input);
+
+  /**
+   * Returns true while the drive's current is being managed.
+   */
+  bool enabled();
+
+  /**
+   * Sets the range the current limit moves in.
+   *
+   * \param max_mA
+   *        limit with cool motors and full grip, 2500 is the motor's max
+   * \param min_mA
+   *        the limit never goes below this
+   * \param stall_mA
+   *        limit while the robot is stalled against something
+   */
+  void current_limits_set(int max_mA, int min_mA, int stall_mA);
+
+  /**
+   * Returns the range the current limit moves in, {max_mA, min_mA, stall_mA}.
+   */
+  std::vector<int> current_limits_get();
+
+  /**
+   * Sets how the current limit reacts to temperature.
+   *
+   * \param limit
+   *        temperature the firmware starts cutting power at, in degrees C
+   * \param range
+   *        headroom where the limit starts coming down, in degrees C
+   */
+  void thermal_constants_set(double limit, double range);
+
+  /**
+   * Sets how the current limit reacts to the wheels slipping.
+   *
+   * \param slip_tolerance
+   *        wheel speed over the ground speed that counts as slipping, in inches per second
+   * \param step
+   *        mA the limit drops each tick while slipping, and recovers at half this rate
+   */
+  void slip_constants_set(double slip_tolerance, int step);
+
+  /**
+   * Sets which IMU axis points forwards.
+   *
+   * \param axis
+   *        traction_control::X_AXIS or traction_control::Y_AXIS
+   * \param reversed
+   *        true if that axis reads negative when accelerating forwards
+   */
+  void imu_axis_set(e_axis axis, bool reversed);
+
+  /**
+   * Measures ground speed with a tracking wheel parallel to the drive instead of the IMU.
+   *
+   * \param tracker
+   *        an ez::tracking_wheel, nullptr goes back to the IMU
+   */
+  void tracker_set(ez::tracking_wheel* tracker);
+
+  /**
+   * Uses timestamped drive encoders from the sensor sampler for wheel speed, instead of differencing every tick.
+   *
+   * \param left
+   *        sampler channel of the left drive in inches, -1 to stop using the sampler
+   * \param right
+   *        sampler channel of the right drive in inches
+   */
+  void wheel_channels_set(int left, int right);
+
+  /**
+   * Returns degrees C before the hottest drive motor reaches the thermal limit.
+   */
+  double thermal_headroom_get();
+
+  /**
+   * Returns the total current draw of the drive in mA.
+   */
+  int current_get();
+
+  /**
+   * Returns the current limit being applied to each drive motor in mA.
+   */
+  int current_limit_get();
+
+  /**
+   * Returns the wheel speed over the ground speed, in inches per second.  0 while the ground speed can't be trusted.
+   */
+  double slip_get();
+
+  /**
+   * Returns true if there's a ground speed to check slip against, always true with a tracker.
+   */
+  bool ground_known();
+
+  /**
+   * Returns true while the robot is stalled against something.
+   */
+  bool stalled();
+
+  /**
+   * Updates the measurements and the current limit.  This is called by the traction task.
+   */
+  void iterate();
+
+ private:
+  int MAX_MA = 2500;
+  int MIN_MA = 1200;
+  int STALL_MA = 1500;
+  double TEMP_LIMIT = 55.0;
+  double TEMP_RANGE = 15.0;
+  double SLIP_TOLERANCE = 8.0;
+  int SLIP_STEP = 60;
+  e_axis imu_axis = Y_AXIS;
+  bool imu_reversed = false;
+  int left_channel = -1;
+  int right_channel = -1;
+  ez::tracking_wheel* ground_tracker = nullptr;
+  double last_tracker_position = 0.0;
+  int drift_time = 0;
+
+  bool running = false;
+  int saved_limit = 2500;
+  int applied_limit = 2500;
+  int grip_limit = 2500;
+  double headroom = 0.0;
+  int current = 0;
+  double wheel_velocity = 0.0;
+  double ground_velocity = 0.0;
+  double last_position = 0.0;
+  int last_time = 0;
+  int stall_time = 0;
+
+  double wheel_position_get();
+  double imu_accel_get();
+  void ground_velocity_update(double imu_accel, double wheel_accel, double dt);
+};
+
+/**
+ * Global traction control.
+ */
+extern traction_control traction;
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "EZ-Template/api.hpp"
+#include "api.h"
+
+/**
+ * Turn in place that follows a velocity profile instead of running PID on heading.
+ *
+ * The robot speeds up at the measured acceleration, cruises at the max turn rate,
+ * and starts braking when the remaining angle matches how far it takes to stop at
+ * the current rate.  Gyro rate is used as feedback on that profile, so the turn
+ * ends at rest instead of creeping in on derivative.
+ *
+ * Once settled, the target is handed to chassis.pid_turn_set() so EZ-Template
+ * holds it until the next motion.
+ */
+class turn_profile {
+ public:
+  turn_profile();
+
+  /**
+   * Starts a profiled turn to an absolute heading, taking the shortest way there.
+   *
+   * \param p_target
+   *        target heading, an okapi angle unit
+   * \param speed
+   *        0 to 127, scales the max turn rate.  0 hands the turn to chassis.pid_turn_set()
+   */
+  void pid_turn_set(okapi::QAngle p_target, int speed);
+
+  /**
+   * Starts a profiled turn to an absolute heading, taking the shortest way there.
+   *
+   * \param target
+   *        target heading in degrees
+   * \param speed
+   *        0 to 127, scales the max turn rate.  0 hands the turn to chassis.pid_turn_set()
+   */
+  void pid_turn_set(double target, int speed);
+
+  /**
+   * Blocks until the turn settles or times out.
+   */
+  void pid_wait();
+
+  /**
+   * Stops the turn and the drive.
+   */
+  void stop();
+
+  /**
+   * Returns true while a turn is running.
+   */
+  bool enabled();
+
+  /**
+   * Sets the limits of the drivetrain when turning in place.
+   *
+   * \param max_rate
+   *        max turn rate in degrees per second
+   * \param accel
+   *        how quickly the robot speeds up, degrees per second per second
+   * \param decel
+   *        how quickly the robot brakes, degrees per second per second
+   */
+  void limits_set(double max_rate, double accel, double decel);
+
+  /**
+   * Returns the limits, {max_rate, accel, decel}.
+   */
+  std::vector<double> limits_get();
+
+  /**
+   * Spins the robot at full power and brakes to measure the limits, then sets and prints them.
+   *
+   * The robot needs about a foot of space around it.
+   */
+  void limits_measure();
+
+  /**
+   * Sets the feedback on the profile.
+   *
+   * \param kp_rate
+   *        output per degree per second the robot is off the profile's rate
+   * \param kp_angle
+   *        caps the profile's rate at this many degrees per second per degree of error, softens the end of the turn
+   */
+  void constants_set(double kp_rate, double kp_angle);
+
+  /**
+   * Returns the feedback constants, {kp_rate, kp_angle}.
+   */
+  std::vector<double> constants_get();
+
+  /**
+   * Sets when the turn is done.
+   *
+   * \param p_tolerance
+   *        how close to the target the robot needs to be, an okapi angle unit
+   * \param settle_rate
+   *        how slow the robot needs to be turning, degrees per second
+   */
+  void exit_condition_set(okapi::QAngle p_tolerance, double settle_rate);
+
+  /**
+   * Flips the sign of the gyro rate if it reads negative when turning right.
+   *
+   * limits_measure() sets this for you.
+   *
+   * \param reversed
+   *        true flips the sign
+   */
+  void gyro_rate_reversed_set(bool reversed);
+
+  /**
+   * Returns the gyro rate in degrees per second, positive turning right.
+   */
+  double gyro_rate_get();
+
+  /**
+   * Returns the rate the profile is asking for, in degrees per second.
+   */
+  double profile_rate_get();
+
+  /**
+   * Runs one iteration of the turn.  This is called by the turn task.
+   */
+  void iterate();
+
+ private:
+  double MAX_RATE = 600.0;
+  double ACCEL = 2500.0;
+  double DECEL = 3000.0;
+  double KP_RATE = 0.05;
+  double KP_ANGLE = 8.0;
+  double TOLERANCE = 1.0;
+  double SETTLE_RATE = 15.0;
+  bool gyro_reversed = false;
+
+  bool running = false;
+  double target = 0.0;
+  int speed_input = 127;
+  double speed_max = 600.0;
+  double profile_rate = 0.0;
+  int start_time = 0;
+  int timeout = 0;
+};
+
+/**
+ * Global profiled turn.
+ */
+extern turn_profile fast_turn;
@@ -45,7 +45,70 @@ void default_constants() {
   chassis.odom_boomerang_distance_set(16_in);  // This sets the maximum distance away from target that the carrot point can be
   chassis.odom_boomerang_dlead_set(0.625);     // This handles how aggressive the end of boomerang motions are
 
+  pursuit.look_ahead_set(5_in, 14_in);  // Look ahead range for the pure pursuit follower, short in bends and long on straights
+  pursuit.velocity_max_set(65);         // Inches per second at full power, 450rpm on 2.75" wheels
+  pursuit.curve_speed_constant_set(5);  // Max speed through a bend is this times the radius of the bend
+  pursuit.curve_decel_set(4);           // Speed lost per inch when slowing down for a bend
+  pursuit.smooth_constants_set(0.75, 0.03);  // How much the path is rounded off between points, 0 disables smoothing
+  pursuit.window_set(40);               // How many injected points the closest point search can move per tick
+  pursuit.rejoin_distance_set(6_in);    // How far off the path before searching the grid to rejoin it
+  pursuit.chain_radius_set(4_in);       // How close to the end of a leg pid_wait_quick_chain() lets the next leg start
+
+  // Profiled turns, these limits are placeholders until the "Measure Turn Limits" auton is run and what it prints is pasted here
+  fast_turn.limits_set(600, 2500, 3000);    // Max turn rate (deg/s), acceleration and braking (deg/s/s)
+  fast_turn.constants_set(0.05, 8.0);       // Gyro rate feedback, and how soft the end of the turn is
+  fast_turn.exit_condition_set(1_deg, 15);  // Done within this angle when turning slower than this rate (deg/s)
+
+  // Profiled boomerangs, these limits are placeholders, so routes stay on chassis.pid_odom_set() until they're measured on the robot
+  fast_boomerang.limits_set(65, 150, 120);          // Max velocity (in/s), acceleration and braking (in/s/s)
+  fast_boomerang.constants_set(1.5, 2.0);           // Velocity feedback, and how hard the robot turns towards the carrot
+  fast_boomerang.exit_condition_set(1_in, 3_deg);   // Done when the robot will stop within this distance and angle
+
+  traction.current_limits_set(2500, 1200, 1500);  // Current limit range while pushing, and the limit while stalled (mA)
+  traction.thermal_constants_set(55, 15);         // Firmware cuts power at this temperature, start backing off this far below it (C)
+  traction.slip_constants_set(8, 60);             // Wheels this much faster than the IMU (in/s) is slipping, mA to drop per tick
+
+  thermal.constants_set(0.08, 0.004);             // Motor heating (C/s per amp squared) and cooling (per second), placeholders until the "Measure Thermal" auton is run and what it prints is pasted here
+  thermal.derate_set(55, 20_s, 2500, 1000);       // Derate motors predicted to reach 55C within 20s, between these limits (mA)
+  thermal.enable(false);                          // true derates the motors below, only once the constants are measured
+  // Motors the thermal model watches, add them once the constants are measured
+  // thermal.drive_add();
+  // thermal.motor_add(intake, "intake");
+  // thermal.motor_add(topintake, "top");
+  // thermal.motor_add(backintake, "back");
+
+  guard.detection_set(0.3, 1800, 100_ms);         // Blocked under this fraction of the speed the voltage should give, over this current (mA), for this long
+  guard.lag_set(150_ms);                          // How long the robot takes to get most of the way up to speed
+  guard.recovery_set(interference_guard::skip()); // What guard.step() does when blocked, autons set their own
+
+  executive.period_set(10_ms);                    // Length of a cyclic executive frame
+  executive.enable(false);                        // true runs every module in one fixed order frame instead of their own tasks
+
+  latency.delay_set(50_ms);                       // How far ahead pursuit and boomerang predict the pose, a placeholder until the "Measure Latency" auton is run and what it prints is pasted here
+  latency.enable(false);                          // true steers from the predicted pose, only once the delay is measured
+
+  predict.constants_set(12, 3.0, 3);              // Errors the settle model is fit to, how many fit RMS errors to allow for, and ticks it has to agree
+
+  telemetry.bandwidth_set(11520);                 // Bytes a second written to the USB port, about what it keeps up with
+  telemetry.enable(false);                        // true streams binary telemetry over USB instead of text, read it with tools/telemetry_decoder.cpp
+
+  profiler.window_set(1000_ms);                   // How long each task's CPU use is averaged over
+
+  driver.correction_constants_set(3.0, 1.5);      // Stick added per inch behind and per degree off a driver recording when replaying
+
+  brain_screen.refresh_rate_set(20);              // Most times a second the brain screen's debug page is redrawn
+  dashboard.bounds_set(-72_in, 0_in, 144_in);    // Area of the field the map covers, left and bottom edges then size
+  dashboard.trail_spacing_set(2_in);              // How far the robot moves between dots in the map's trail
+
   chassis.pid_angle_behavior_set(ez::shortest);  // Changes the default behavior for turning, this defaults it to the shortest path there
+
+  // Gain schedules for pid_*_scheduled_set, indexed by max speed
+  // - each table only has the row tuned at DRIVE_SPEED, TURN_SPEED or SWING_SPEED, so every speed gets the constants above
+  // - tune the PID at another speed and add it as a row, speeds between rows blend them
+  // - drive_backward_gains is left empty, so backward drives use the forward table
+  drive_forward_gains.points_set({{DRIVE_SPEED, {60, 0.0, 520}}});
+  turn_gains.points_set({{TURN_SPEED, {40.0, 0.05, 295.0, 15.0}}});
+  swing_gains.points_set({{SWING_SPEED, {6.0, 0.0, 65.0}}});
 }
 
 ///
@@ -84,6 +147,23 @@ void turn_example() {
   chassis.pid_wait();
 }
 
+///
+// Profiled Turns
+///
+void profiled_turn_example() {
+  // Same as turn_example(), but each turn follows the limits in default_constants()
+  // Measure them with the "Measure Turn Limits" auton first
+
+  fast_turn.pid_turn_set(90_deg, TURN_SPEED);
+  fast_turn.pid_wait();
+
+  fast_turn.pid_turn_set(45_deg, TURN_SPEED);
+  fast_turn.pid_wait();
+
+  fast_turn.pid_turn_set(0_deg, TURN_SPEED);
+  fast_turn.pid_wait();
+}
+
 ///
 // Combining Turn + Drive
 ///
@@ -202,36 +282,11 @@ void combining_movements() {
 ///
 // Interference example
 ///
-void tug(int attempts) {
-  for (int i = 0; i < attempts - 1; i++) {
-    // Attempt to drive backward
-    printf("i - %i", i);
-    chassis.pid_drive_set(-12_in, 127);
-    chassis.pid_wait();
-
-    // If failsafed...
-    if (chassis.interfered) {
-      chassis.drive_sensor_reset();
-      chassis.pid_drive_set(-2_in, 20);
-      pros::delay(1000);
-    }
-    // If the robot successfully drove back, return
-    else {
-      return;
-    }
-  }
-}
-
 // If there is no interference, the robot will drive forward and turn 90 degrees.
-// If interfered, the robot will drive forward and then attempt to drive backward.
+// If it's blocked, the robot backs off and tries again, and skips the turn if it still can't get there.
 void interfered_example() {
-  chassis.pid_drive_set(24_in, DRIVE_SPEED, true);
-  chassis.pid_wait();
-
-  if (chassis.interfered) {
-    tug(3);
-    return;
-  }
+  guard.recovery_set(interference_guard::back_off(6_in, 2));
+  if (!guard.step([] { chassis.pid_drive_set(24_in, DRIVE_SPEED, true); })) return;
 
   chassis.pid_turn_set(90_deg, TURN_SPEED);
   chassis.pid_wait();
@@ -272,6 +327,22 @@ void odom_pure_pursuit_example() {
   chassis.pid_wait();
 }
 
+///
+// Windowed Pure Pursuit
+///
+void windowed_pursuit_example() {
+  // Same path as odom_pure_pursuit_example(), followed by pursuit instead of EZ-Template
+  // pursuit ramps its own speed along the path, so there's no slew
+  pursuit.pid_pursuit_set({{{6_in, 10_in}, fwd, DRIVE_SPEED},
+                           {{0_in, 20_in}, fwd, DRIVE_SPEED},
+                           {{0_in, 30_in}, fwd, DRIVE_SPEED}});
+  pursuit.pid_wait();
+
+  // Drive to 0, 0 backwards
+  pursuit.pid_pursuit_set({{0_in, 0_in}, rev, DRIVE_SPEED});
+  pursuit.pid_wait();
+}
+
 ///
 // Odom Pure Pursuit Wait Until
 ///
@@ -314,6 +385,121 @@ void odom_boomerang_injected_pure_pursuit_example() {
   chassis.pid_wait();
 }
 
+///
+// Measure how fast the robot can turn, for profiled turns
+///
+void measure_turn_limits() {
+  chassis.drive_imu_reset();
+  fast_turn.limits_measure();
+}
+
+///
+// Measure how motors heat and cool, for the thermal model
+///
+void measure_thermal() {
+  // Jam the intake so it stalls, it has to draw a lot of current to heat up in 3 minutes
+  thermal.constants_measure(intake, 180_s, 300_s);
+}
+
+///
+// Replay a driver recording made in opcontrol
+///
+void replay_driver() {
+  chassis.drive_brake_set(MOTOR_BRAKE_COAST);  // Drive the same as opcontrol
+  if (!driver.replay_start("/usd/driver.rec")) return;
+
+  while (driver.replaying()) {
+    opcontrol_iterate();
+    opcontrol_routine_run();
+    pros::delay(ez::util::DELAY_TIME);
+  }
+  chassis.drive_set(0, 0);
+}
+
+///
+// Measure how long the drive takes to respond to a command, for latency compensation
+///
+void measure_latency() {
+  // The steps alternate forwards and backwards, so give the robot about 2 feet of room both ways
+  latency.measure(6, 80);
+}
+
+///
+// Run the route compiled onto the SD card, it's loaded in initialize()
+///
+void sd_card_route() {
+  sd_route.run();
+}
+
+///
+// Time the PID and slew math from EZ-Template's library against a budget, results print to the terminal
+//  - the rest of the math that runs every tick is timed on a computer by tools/tick_benchmark.cpp
+///
+void run_benchmarks() {
+  bench.clear();
+
+  ez::PID pid(20, 0.1, 100, 10);
+  pid.target_set(24);
+  bench.add("PID::compute", 3000, [&](int n) { for (int i = 0; i < n; i++) bench.sink(pid.compute(i % 24)); });
+  bench.add("PID::compute_error", 3000, [&](int n) { for (int i = 0; i < n; i++) bench.sink(pid.compute_error(24 - i % 24, i % 24)); });
+
+  ez::slew slew(3, 70);
+  slew.initialize(true, 127, 24, 0);
+  bench.add("slew::iterate", 1000, [&](int n) { for (int i = 0; i < n; i++) bench.sink(slew.iterate(i % 24)); });
+
+  bench.run(10000, 5);
+}
+
+///
+// Simulate drive motions and turns, comparing normal exits against predicted ones in the terminal
+///
+void exit_simulation() {
+  // Robot response to a motor command, top speed and how long it takes to get there
+  struct plant {
+    const char* name;
+    ez::PID* pid;
+    double max_speed;
+    double lag;
+  };
+  plant plants[2] = {{"drive", &chassis.leftPID, 60.0, 0.08},
+                     {"turn", &chassis.turnPID, 500.0, 0.06}};
+  double targets[2][4] = {{6, 12, 24, 48}, {15, 45, 90, 180}};
+  std::vector<double> k = predict.constants_get();
+  double dt = ez::util::DELAY_TIME / 1000.0;
+
+  printf("\n%-6s %7s %10s %10s %10s %10s\n", "motion", "target", "normal ms", "predict ms", "predicted", "rest");
+  for (int p = 0; p < 2; p++) {
+    ez::PID::Constants c = plants[p].pid->constants_get();
+    ez::PID::exit_condition_ exit = plants[p].pid->exit;
+    for (int t = 0; t < 4; t++) {
+      ez::PID pid(c.kp, c.ki, c.kd, c.start_i);
+      pid.exit_condition_set(exit.small_exit_time, exit.small_error, exit.big_exit_time, exit.big_error, exit.velocity_exit_time, 0);
+      pid.target_set(targets[p][t]);
+      predictive_exit model;
+      model.constants_set(k[0], k[1], k[2]);
+
+      double x = 0.0, v = 0.0, predicted = NAN;
+      int normal_ms = -1, predict_ms = -1;
+      for (int tick = 0; tick < 500; tick++) {
+        double output = ez::util::clamp(pid.compute(x), 127.0, -127.0);
+
+        // Below this the motors can't overcome friction
+        double command = fabs(output) < 8.0 ? 0.0 : output;
+        v += (command / 127.0 * plants[p].max_speed - v) * dt / plants[p].lag;
+        x += v * dt;
+
+        int now = (tick + 1) * ez::util::DELAY_TIME;
+        if (normal_ms < 0 && pid.exit_condition() != ez::RUNNING) normal_ms = now;
+        if (predict_ms < 0 && model.update(pid.error, exit.small_error) && fabs(pid.error) <= std::max(exit.big_error, exit.small_error)) {
+          predict_ms = now;
+          predicted = model.prediction_get();
+        }
+      }
+      printf("%-6s %7.1f %10i %10i %10.2f %10.2f\n", plants[p].name, targets[p][t], normal_ms, predict_ms, predicted, targets[p][t] - x);
+    }
+  }
+}
+
 ///
 // Calculate the offsets of your tracking wheels
 ///
@@ -771,8 +957,8 @@ for (int i = 0; i < 4; i++) {
   chassis.pid_turn_set(100_deg, TURN_SPEED);
   chassis.pid_wait();
 
-    chassis.pid_drive_set(24_in, 127, true);
-  chassis.pid_wait();
+    traction.pid_push_set(24_in, 127, true);
+  traction.pid_wait();
 
 
 
@@ -1338,17 +1524,14 @@ void sixThreeLow() {
 
 
 
-   chassis.pid_odom_set({{{19.5_in, 20_in}, fwd, normal},
-                        { {24_in, 42_in}, fwd, 60}},
-                        true);
-    chassis.pid_wait();
+   pursuit.pid_pursuit_set({{{19.5_in, 20_in}, fwd, normal},
+                           { {24_in, 42_in}, fwd, 60}});
+    pursuit.pid_wait_quick_chain();  // Keep moving into the matchloader
    matchload.set(true);
 
 
-     chassis.pid_odom_set({{{25_in, 45_in}, fwd, normal},
-                        },
-                        true);
-    chassis.pid_wait();
+     pursuit.pid_pursuit_set({{25_in, 45_in}, fwd, normal});
+    pursuit.pid_wait();
 
      pros::delay(200);
    
@@ -1504,14 +1687,14 @@ void skillsWait() {
 chassis.pid_wait();
 
 
-  chassis.pid_swing_set(ez::RIGHT_SWING, 90_deg, 50, 10);
+  pid_swing_scheduled_set(ez::RIGHT_SWING, 90_deg, 50, 10);
   chassis.pid_wait();
 
-    chassis.pid_drive_set(-10_in, 110, true);
+    pid_drive_scheduled_set(-10_in, 110, true);
   chassis.pid_wait();
 
-  chassis.pid_drive_set(70_in, 127, true);
-  chassis.pid_wait();
+  traction.pid_push_set(70_in, 127, true);
+  traction.pid_wait();
 }
 
 void hi() {
@@ -1606,88 +1789,6 @@ chassis.pid_turn_set(180_deg,90);
 
              pros::delay(3000);
 
-}
-
-void fullSkills() {
-/*
-// pick up balls from park zone
-intake.move(-127);  topintake.move(127);
-chassis.pid_drive_set(65_in, 127, true); chassis.pid_wait();
-// move around inside the parkzone so balls can get picked up
-chassis.pid_turn_set(15_deg,90); chassis.pid_wait(); 
-chassis.pid_turn_set(-15_deg,90); chassis.pid_wait();
-chassis.pid_turn_set(15_deg,90); chassis.pid_wait(); 
-chassis.pid_turn_set(-15_deg,90); chassis.pid_wait();  
-chassis.pid_turn_set(0_deg,90); chassis.pid_wait(); */
-
-// leave park zone
-//chassis.pid_drive_set(-30_in, 110, true); chassis.pid_wait();
-//chassis.pid_drive_set(10_in, 70, true); chassis.pid_wait();
-// distance sensor reset
-intake.move(-127);  topintake.move(127);
-double parkAlign = (rightDS.get() / 24.0) - 70;
-chassis.odom_xyt_set(parkAlign, 24, 180);
-
-// align to middle goal
-chassis.pid_odom_set({{{-10_in, 56_in,150_deg}, rev, normal},}, true); chassis.pid_wait();
-chassis.pid_swing_set(ez::RIGHT_SWING, -135_deg, SWING_SPEED, 10); chassis.pid_wait();
-med.set(false); small.set(true);
-pros::delay(300);
-small.set(false);
-med.set(false);         
-// pick up 7th ball
-chassis.pid_drive_set(11_in, 60, true); chassis.pid_wait();
-chassis.pid_drive_set(-11_in, 60, true); chassis.pid_wait();
-// score middle goal 
-intake.move(-110); topintake.move(110);
-med.set(false); small.set(true);
-pros::delay(1000);
-intake.move(-60); topintake.move(60);
-pros::delay(1400);  
-// go back a little bit so when the triple stage flap closes it doesnt fling all the balls out    
-chassis.pid_drive_set(3_in, 60, true); chassis.pid_wait();
-med.set(false); small.set(false);
-
-// align to matchload and pick up the 3 blocks
-intake.move(-127); topintake.move(127);
-chassis.pid_odom_set({{{-24_in, 48_in}, fwd, 110}, // pick up the 3 balls left in the 4 block square
-                      {{-24_in, 48_in}, fwd, 110}, // only here to drop the matchload
-                      {{-49_in, 27_in}, fwd, 110},}, true);
-chassis.pid_wait_until_index(1);  // Waits until the robot passes 
-matchload.set(true); // wait until it reaches -24, 48 to drop matchload stopping the balls just picked up from escaping
-chassis.pid_wait();
-
-chassis.pid_turn_set(180_deg,90); chassis.pid_wait();
-chassis.pid_drive_set(14_in, 110, true); chassis.pid_wait();
-
-pros::delay(1000);
-
-chassis.pid_odom_set({{{-49_in,24_in}, rev, 110}, // exit out of matchload
-                      {{-35_in, 48_in}, rev, 110},}, true);// begin travelling to the other side of the field
-chassis.pid_wait();
-chassis.pid_turn_set(180_deg,90); chassis.pid_wait();
-
-chassis.pid_odom_set(-60_in, 110, true); chassis.pid_wait(); 
-chassis.pid_turn_set(90_deg,90); chassis.pid_wait();
-
-double firstGoalAlign = ((backDS.get() / 24.0) - 23) * -1;
-chassis.pid_odom_set(firstGoalAlign, 110, true); chassis.pid_wait(); 
-//chassis.pid_odom_set({{{24_in, 108_in}, fwd, normal},},true);
-chassis.pid_turn_set(0_deg,90); chassis.pid_wait();
-chassis.pid_odom_set(-10_in, 110, true); chassis.pid_wait(); 
-med.set(true); small.set(false);
-pros::delay(2000);
-chassis.odom_xyt_set(-48_in,104_in,0_deg);
-small.set(false);
-med.set(false);
-
-chassis.pid_odom_set({{{-47_in, 130_in}, fwd, normal},}, true); chassis.pid_wait();
-pros::delay(1000);
-chassis.pid_odom_set({{{-48_in, 104_in}, fwd, normal},}, true); chassis.pid_wait();
-med.set(true);
-small.set(false);
-
-
 }
 
 void fourRush() {
@@ -0,0 +1,51 @@
+#include "main.h"
+
+benchmark bench;
+
+benchmark::benchmark() {}
+
+bool benchmark::add(const char* name, double budget, std::function<void(int)> body) {
+  if (count >= MAX_CASES) return false;
+  cases[count] = {name, budget, body};
+  results[count] = {name, 0.0, budget, false};
+  count++;
+  return true;
+}
+
+void benchmark::clear() { count = 0; }
+
+double benchmark::time(const std::function<void(int)>& body, int iterations, int repeats) {
+  double best = INFINITY;
+  for (int r = 0; r < repeats; r++) {
+    std::uint64_t start = pros::micros();
+    body(iterations);
+    std::uint64_t elapsed = pros::micros() - start;
+    best = std::min(best, elapsed * 1000.0 / iterations);
+
+    // Let everything else run so it doesn't pile up on the next run
+    pros::delay(ez::util::DELAY_TIME);
+  }
+  return best;
+}
+
+int benchmark::run(int iterations, int repeats) {
+  iterations = std::max(iterations, 1);
+  repeats = std::max(repeats, 1);
+
+  // What the loop and sink cost on their own
+  double overhead = time([this](int n) { for (int i = 0; i < n; i++) sink(i); }, iterations, repeats);
+
+  int failed = 0;
+  printf("\n%-28s %10s %10s\n", "benchmark", "ns/op", "budget");
+  for (int i = 0; i < count; i++) {
+    double ns = std::max(time(cases[i].body, iterations, repeats) - overhead, 0.0);
+    results[i].ns_per_op = ns;
+    results[i].passed = ns <= cases[i].budget;
+    if (!results[i].passed) failed++;
+    printf("%-28s %10.1f %10.1f  %s\n", cases[i].name, ns, cases[i].budget, results[i].passed ? "ok" : "OVER");
+  }
+  printf("%i of %i over budget, loop overhead %.1f ns/op\n", failed, count, overhead);
+  return failed;
+}
+
+std::vector<benchmark::result> benchmark::results_get() { return std::vector<result>(results, results + count); }
@@ -0,0 +1,174 @@
+#include "main.h"
+
+boomerang_profile fast_boomerang;
+
+// Inside this distance the robot turns to the target angle instead of the carrot
+const double FINAL_TURN_DISTANCE = 3.0;
+
+// Least acceleration and braking the profile plans with, 0 would never reach speed or stop
+const double LIMIT_MIN = 1.0;
+
+boomerang_profile::boomerang_profile() {}
+
+void boomerang_profile::pid_boomerang_set(ez::united_odom p_imovement) {
+  pid_boomerang_set(ez::util::united_odom_to_odom(p_imovement));
+}
+
+void boomerang_profile::pid_boomerang_set(ez::odom imovement) {
+  target = imovement;
+  velocity_max = MAX_VELOCITY * ez::util::clamp(abs(imovement.max_xy_speed), 127, 0) / 127.0;
+
+  // There's no profile at 0 speed, EZ-Template gets the motion like any other
+  if (velocity_max <= 0.0) {
+    running = false;
+    chassis.pid_odom_boomerang_set(imovement);
+    return;
+  }
+
+  profile_velocity = 0.0;
+  velocity = 0.0;
+  last_pose = chassis.odom_pose_get();
+  last_time = pros::millis();
+  remaining = ez::util::distance_to_point(carrot_get(last_pose), last_pose) + ez::util::distance_to_point(target.target, carrot_get(last_pose));
+
+  // Give the motion one and a half times what the profile should take
+  double profile_time = remaining / velocity_max + velocity_max / (2.0 * ACCEL) + velocity_max / (2.0 * DECEL);
+  timeout = profile_time * 1500.0 + 300;
+  start_time = pros::millis();
+
+  // EZ-Template stays idle while this motion drives
+  chassis.drive_mode_set(ez::DISABLE, false);
+  running = true;
+}
+
+ez::pose boomerang_profile::carrot_get(ez::pose current) {
+  if (target.target.theta == ez::ANGLE_NOT_SET) return target.target;
+
+  // Same carrot as EZ-Template, pulled back along the target angle by the distance left
+  double distance = std::min(ez::util::distance_to_point(target.target, current), chassis.odom_boomerang_distance_get());
+  double lead = distance * chassis.odom_boomerang_dlead_get();
+  ez::pose carrot = ez::util::vector_off_point(target.drive_direction == ez::rev ? lead : -lead, target.target);
+  carrot.theta = target.target.theta;
+  return carrot;
+}
+
+void boomerang_profile::velocity_update(ez::pose current) {
+  int now = pros::millis();
+  int dt = now - last_time;
+  if (dt <= 0) return;
+
+  // Velocity along the robot's heading, so sliding sideways doesn't count
+  double heading = ez::util::to_rad(current.theta);
+  double along = (current.x - last_pose.x) * sin(heading) + (current.y - last_pose.y) * cos(heading);
+  double measured = along / (dt / 1000.0);
+  if (target.drive_direction == ez::rev) measured = -measured;
+  velocity = velocity * 0.7 + measured * 0.3;
+  last_pose = current;
+  last_time = now;
+}
+
+void boomerang_profile::iterate() {
+  if (!running) return;
+
+  // Something else took over the drive
+  if (chassis.drive_mode_get() != ez::DISABLE) {
+    running = false;
+    return;
+  }
+
+  ez::pose current = chassis.odom_pose_get();
+  velocity_update(current);
+  current = latency.pose_predict(current);
+
+  ez::pose carrot = carrot_get(current);
+  double distance = ez::util::distance_to_point(target.target, current);
+  remaining = ez::util::distance_to_point(carrot, current) + ez::util::distance_to_point(target.target, carrot);
+
+  // Point at the carrot until close, then at the target angle
+  double facing = current.theta + (target.drive_direction == ez::rev ? 180.0 : 0.0);
+  bool has_angle = target.target.theta != ez::ANGLE_NOT_SET;
+  double heading_error = distance < FINAL_TURN_DISTANCE && has_angle ? ez::util::wrap_angle(target.target.theta - current.theta)
+                                                                     : ez::util::wrap_angle(ez::util::absolute_angle_to_point(carrot, current) - facing);
+
+  // Braking from here stops the robot this far along the curve
+  double v = std::max(velocity, 0.0);
+  double stop_distance = (v * v) / (2.0 * DECEL);
+  settle_time = (v / DECEL + std::max(remaining - stop_distance, 0.0) / std::max(v, ACCEL * ez::util::DELAY_TIME / 1000.0)) * 1000.0;
+
+  // Safe to let EZ-Template hold the target, or ran out of time
+  bool stops_in_tolerance = fabs(remaining - stop_distance) < TOLERANCE;
+  bool angle_in_tolerance = !has_angle || fabs(ez::util::wrap_angle(target.target.theta - current.theta)) < ANGLE_TOLERANCE;
+  if ((stops_in_tolerance && angle_in_tolerance) || (int)pros::millis() - start_time > timeout) {
+    // EZ-Template has the motion before this stops, so motion events see one motion
+    chassis.pid_odom_set(target, false);
+    running = false;
+    settle_time = 0.0;
+    return;
+  }
+
+  // Fastest velocity that can still stop in the remaining curve, and slower when pointed away from the carrot
+  double brake_velocity = sqrt(2.0 * DECEL * remaining);
+  double heading_scale = std::max(cos(ez::util::to_rad(heading_error)), 0.0);
+  double ramp_velocity = std::max(profile_velocity, 0.0) + ACCEL * (ez::util::DELAY_TIME / 1000.0);
+  profile_velocity = std::min({velocity_max, brake_velocity, ramp_velocity}) * heading_scale;
+
+  // Feedforward from the max velocity plus feedback on odom
+  double forward = profile_velocity * (127.0 / MAX_VELOCITY) + KP_VELOCITY * (profile_velocity - velocity);
+  if (target.drive_direction == ez::rev) forward = -forward;
+  double turn = KP_HEADING * heading_error;
+
+  // Turning is prioritized so the robot stays on the curve
+  double left = forward + turn;
+  double right = forward - turn;
+  double scale = std::max({fabs(left), fabs(right), 127.0}) / 127.0;
+  chassis.drive_set(left / scale, right / scale);
+}
+
+void boomerang_profile::pid_wait() {
+  while (running)
+    pros::delay(ez::util::DELAY_TIME);
+}
+
+void boomerang_profile::stop() {
+  running = false;
+  chassis.drive_set(0, 0);
+}
+
+bool boomerang_profile::enabled() { return running; }
+
+void boomerang_profile::limits_set(double max_velocity, double accel, double decel) {
+  MAX_VELOCITY = fabs(max_velocity);
+  ACCEL = std::max(fabs(accel), LIMIT_MIN);
+  DECEL = std::max(fabs(decel), LIMIT_MIN);
+}
+std::vector<double> boomerang_profile::limits_get() { return {MAX_VELOCITY, ACCEL, DECEL}; }
+
+void boomerang_profile::constants_set(double kp_velocity, double kp_heading) {
+  KP_VELOCITY = kp_velocity;
+  KP_HEADING = kp_heading;
+}
+std::vector<double> boomerang_profile::constants_get() { return {KP_VELOCITY, KP_HEADING}; }
+
+void boomerang_profile::exit_condition_set(okapi::QLength p_tolerance, okapi::QAngle p_angle_tolerance) {
+  TOLERANCE = p_tolerance.convert(okapi::inch);
+  ANGLE_TOLERANCE = p_angle_tolerance.convert(okapi::degree);
+}
+
+double boomerang_profile::remaining_get() { return remaining; }
+
+double boomerang_profile::settle_time_get() { return settle_time; }
+
+double boomerang_profile::profile_velocity_get() { return profile_velocity; }
+
+double boomerang_profile::velocity_get() { return velocity; }
+
+/**
+ * Runs the profiled boomerang every 10ms
+ */
+void boomerang_profile_task() {
+  while (true) {
+    if (!executive.enabled()) fast_boomerang.iterate();
+    pros::delay(ez::util::DELAY_TIME);
+  }
+}
+pros::Task boomerangProfileTask(boomerang_profile_task, "Boomerang Profile");
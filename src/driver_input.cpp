@@ -0,0 +1,324 @@
+#include "main.h"
+
+driver_input driver;
+
+// Recording file layout, a header followed by one record per tick
+//   header: "EZRC", version, starting x, y, theta as floats
+//   record: flags, then only the fields the flags say changed
+//     ANALOG_CHANGED << i   int8 stick i
+//     BUTTONS_CHANGED       uint16 buttons, bit 0 is DIGITAL_L1
+//     POSE_CHANGED          int16 x, y, theta change in hundredths
+//     TIME_CHANGED          uint16 ms since the last record, otherwise it's DELAY_TIME
+const char MAGIC[4] = {'E', 'Z', 'R', 'C'};
+const std::uint8_t VERSION = 1;
+const int HEADER_SIZE = 4 + 1 + 3 * sizeof(float);
+const std::uint8_t ANALOG_CHANGED = 1 << 0;
+const std::uint8_t BUTTONS_CHANGED = 1 << 4;
+const std::uint8_t POSE_CHANGED = 1 << 5;
+const std::uint8_t TIME_CHANGED = 1 << 6;
+const int BUTTON_COUNT = 12;
+
+driver_input::driver_input() {}
+
+void driver_input::iterate() {
+  last_buttons = current.buttons;
+
+  if (!is_replaying) {
+    current = controller_sample();
+    current.time = pros::millis() - start_time;
+    driver_lock.take();
+    if (is_recording) encode(current);
+    driver_lock.give();
+    return;
+  }
+
+  // Step through every record that's due
+  int elapsed = pros::millis() - start_time;
+  while (has_next && next.time <= elapsed) {
+    current = next;
+    has_next = decode(next);
+  }
+
+  // Ran out of recording
+  if (!has_next && elapsed > current.time) replay_stop();
+}
+
+driver_input::sample driver_input::controller_sample() {
+  sample output;
+  for (int i = 0; i < 4; i++)
+    output.analog[i] = ez::util::clamp(master.get_analog((pros::controller_analog_e_t)i), 127, -127);
+  for (int i = 0; i < BUTTON_COUNT; i++) {
+    if (master.get_digital((pros::controller_digital_e_t)(pros::E_CONTROLLER_DIGITAL_L1 + i)))
+      output.buttons |= 1 << i;
+  }
+  output.pose = chassis.odom_pose_get();
+  return output;
+}
+
+int driver_input::get_analog(pros::controller_analog_e_t channel) {
+  int index = ez::util::clamp(channel, 3, 0);
+  double output = current.analog[index];
+  if (!is_replaying) return output;
+
+  // Pull the robot towards where it was at this point in the recording
+  ez::pose pose = chassis.odom_pose_get();
+  double heading = ez::util::to_rad(current.pose.theta);
+  double dx = current.pose.x - pose.x;
+  double dy = current.pose.y - pose.y;
+  if (channel == pros::E_CONTROLLER_ANALOG_LEFT_Y)
+    output += KP_DRIVE * (dx * sin(heading) + dy * cos(heading));
+  else if (channel == pros::E_CONTROLLER_ANALOG_RIGHT_X)
+    output += KP_TURN * ez::util::wrap_angle(current.pose.theta - pose.theta);
+  return ez::util::clamp(output, 127.0);
+}
+
+bool driver_input::get_digital(pros::controller_digital_e_t button) {
+  int bit = button - pros::E_CONTROLLER_DIGITAL_L1;
+  if (bit < 0 || bit >= BUTTON_COUNT) return false;
+  return current.buttons & (1 << bit);
+}
+
+bool driver_input::get_digital_new_press(pros::controller_digital_e_t button) {
+  int bit = button - pros::E_CONTROLLER_DIGITAL_L1;
+  if (bit < 0 || bit >= BUTTON_COUNT) return false;
+  return (current.buttons & (1 << bit)) && !(last_buttons & (1 << bit));
+}
+
+void driver_input::encode(const sample& input) {
+  std::uint8_t flags = 0;
+  std::uint8_t body[4 + 2 + 6 + 2];
+  int size = 0;
+
+  for (int i = 0; i < 4; i++) {
+    if (input.analog[i] != encoded.analog[i]) {
+      flags |= ANALOG_CHANGED << i;
+      body[size++] = input.analog[i];
+    }
+  }
+
+  if (input.buttons != encoded.buttons) {
+    flags |= BUTTONS_CHANGED;
+    body[size++] = input.buttons & 0xFF;
+    body[size++] = input.buttons >> 8;
+  }
+
+  // Deltas are taken between rounded values so error doesn't build up over a run
+  std::int16_t deltas[3] = {
+      (std::int16_t)ez::util::clamp(lround(input.pose.x * 100.0) - lround(encoded.pose.x * 100.0), 32767, -32767),
+      (std::int16_t)ez::util::clamp(lround(input.pose.y * 100.0) - lround(encoded.pose.y * 100.0), 32767, -32767),
+      (std::int16_t)ez::util::clamp(lround(input.pose.theta * 100.0) - lround(encoded.pose.theta * 100.0), 32767, -32767)};
+  if (deltas[0] != 0 || deltas[1] != 0 || deltas[2] != 0) {
+    flags |= POSE_CHANGED;
+    for (int i = 0; i < 3; i++) {
+      body[size++] = deltas[i] & 0xFF;
+      body[size++] = (deltas[i] >> 8) & 0xFF;
+    }
+  }
+
+  int dt = input.time - encoded.time;
+  if (dt != ez::util::DELAY_TIME) {
+    flags |= TIME_CHANGED;
+    dt = ez::util::clamp(dt, 65535, 0);
+    body[size++] = dt & 0xFF;
+    body[size++] = dt >> 8;
+  }
+
+  // The card fell too far behind, stop here so the file still ends on a whole record
+  if (pending_size + 1 + size > BUFFER_BYTES) {
+    is_recording = false;
+    record_failed = true;
+    return;
+  }
+  pending[pending_size++] = flags;
+  memcpy(&pending[pending_size], body, size);
+  pending_size += size;
+
+  // Track what the decoder will see, not the raw input
+  for (int i = 0; i < 4; i++)
+    encoded.analog[i] = input.analog[i];
+  encoded.buttons = input.buttons;
+  encoded.pose.x = (lround(encoded.pose.x * 100.0) + deltas[0]) / 100.0;
+  encoded.pose.y = (lround(encoded.pose.y * 100.0) + deltas[1]) / 100.0;
+  encoded.pose.theta = (lround(encoded.pose.theta * 100.0) + deltas[2]) / 100.0;
+  encoded.time += dt;
+}
+
+bool driver_input::decode(sample& output) {
+  if (read_index >= (int)data.size()) return false;
+
+  std::uint8_t flags = data[read_index];
+  int size = 1;
+  for (int i = 0; i < 4; i++)
+    size += (flags & (ANALOG_CHANGED << i)) ? 1 : 0;
+  size += (flags & BUTTONS_CHANGED) ? 2 : 0;
+  size += (flags & POSE_CHANGED) ? 6 : 0;
+  size += (flags & TIME_CHANGED) ? 2 : 0;
+  if (read_index + size > (int)data.size()) return false;  // Cut off part way through a record
+
+  const std::uint8_t* body = &data[read_index + 1];
+  read_index += size;
+
+  for (int i = 0; i < 4; i++) {
+    if (flags & (ANALOG_CHANGED << i))
+      encoded.analog[i] = (std::int8_t)*body++;
+  }
+
+  if (flags & BUTTONS_CHANGED) {
+    encoded.buttons = body[0] | (body[1] << 8);
+    body += 2;
+  }
+
+  if (flags & POSE_CHANGED) {
+    std::int16_t deltas[3];
+    for (int i = 0; i < 3; i++) {
+      deltas[i] = (std::int16_t)(body[0] | (body[1] << 8));
+      body += 2;
+    }
+    encoded.pose.x = (lround(encoded.pose.x * 100.0) + deltas[0]) / 100.0;
+    encoded.pose.y = (lround(encoded.pose.y * 100.0) + deltas[1]) / 100.0;
+    encoded.pose.theta = (lround(encoded.pose.theta * 100.0) + deltas[2]) / 100.0;
+  }
+
+  encoded.time += (flags & TIME_CHANGED) ? (body[0] | (body[1] << 8)) : ez::util::DELAY_TIME;
+
+  output = encoded;
+  return true;
+}
+
+bool driver_input::record_start(std::string file) {
+  if (is_replaying || is_recording) return false;
+
+  // A recording the SD card fell behind on is still open
+  if (record_file != nullptr) record_stop();
+
+  if (!ez::util::SD_CARD_ACTIVE) {
+    printf("No SD card, driver recording can't be saved\n");
+    return false;
+  }
+
+  ez::pose start = chassis.odom_pose_get();
+  float header_pose[3] = {(float)start.x, (float)start.y, (float)start.theta};
+
+  file_lock.take();
+  record_file = fopen(file.c_str(), "wb");
+  bool opened = record_file != nullptr;
+  if (opened) {
+    fwrite(MAGIC, 1, 4, record_file);
+    fwrite(&VERSION, 1, 1, record_file);
+    fwrite(header_pose, 1, sizeof(header_pose), record_file);
+  }
+  record_bytes = HEADER_SIZE;
+  record_failed = false;
+  file_lock.give();
+  if (!opened) return false;
+
+  // The header's pose went through a float, so deltas start from that
+  driver_lock.take();
+  pending_size = 0;
+  encoded = sample();
+  encoded.pose = {header_pose[0], header_pose[1], header_pose[2]};
+  start_time = pros::millis();
+  is_recording = true;
+  driver_lock.give();
+  return true;
+}
+
+bool driver_input::record_stop() {
+  driver_lock.take();
+  is_recording = false;
+  driver_lock.give();
+
+  // Write what the recorder task hasn't gotten to yet
+  flush();
+  file_lock.take();
+  if (record_file == nullptr) {
+    file_lock.give();
+    return false;
+  }
+  fclose(record_file);
+  record_file = nullptr;
+  bool written = !record_failed;
+  file_lock.give();
+
+  printf("Saved %i bytes of driver recording%s\n", record_bytes, written ? "" : ", it was cut off when the SD card fell behind");
+  return written;
+}
+
+bool driver_input::recording() { return is_recording; }
+
+void driver_input::flush() {
+  static std::uint8_t block[BUFFER_BYTES];
+
+  // Only the SD card write holds up the file, recording keeps going into pending meanwhile
+  file_lock.take();
+  driver_lock.take();
+  int size = pending_size;
+  memcpy(block, pending, size);
+  pending_size = 0;
+  driver_lock.give();
+
+  if (record_file != nullptr && size > 0) {
+    if ((int)fwrite(block, 1, size, record_file) != size) record_failed = true;
+    fflush(record_file);
+    record_bytes += size;
+  }
+  file_lock.give();
+}
+
+bool driver_input::replay_start(std::string file) {
+  if (is_recording || !ez::util::SD_CARD_ACTIVE) return false;
+
+  FILE* input = fopen(file.c_str(), "rb");
+  if (input == nullptr) return false;
+  fseek(input, 0, SEEK_END);
+  long size = ftell(input);
+  fseek(input, 0, SEEK_SET);
+  data.resize(size > 0 ? size : 0);
+  bool read = size > HEADER_SIZE && fread(data.data(), 1, data.size(), input) == data.size();
+  fclose(input);
+
+  if (!read || memcmp(data.data(), MAGIC, 4) != 0 || data[4] != VERSION) {
+    printf("%s isn't a driver recording\n", file.c_str());
+    return false;
+  }
+
+  float header_pose[3];
+  memcpy(header_pose, &data[5], sizeof(header_pose));
+  chassis.odom_xyt_set(header_pose[0], header_pose[1], header_pose[2]);
+
+  encoded = sample();
+  encoded.pose = {header_pose[0], header_pose[1], header_pose[2]};
+  read_index = HEADER_SIZE;
+  current = sample();
+  current.pose = encoded.pose;
+  last_buttons = 0;
+  has_next = decode(next);
+  start_time = pros::millis();
+  is_replaying = true;
+  return true;
+}
+
+void driver_input::replay_stop() {
+  is_replaying = false;
+  current = sample();
+  last_buttons = 0;
+}
+
+bool driver_input::replaying() { return is_replaying; }
+
+void driver_input::correction_constants_set(double kp_drive, double kp_turn) {
+  KP_DRIVE = kp_drive;
+  KP_TURN = kp_turn;
+}
+std::vector<double> driver_input::correction_constants_get() { return {KP_DRIVE, KP_TURN}; }
+
+/**
+ * Writes driver recordings to the SD card every 100ms
+ */
+void driver_recorder_task() {
+  while (true) {
+    driver.flush();
+    pros::delay(100);
+  }
+}
+pros::Task driverRecorderTask(driver_recorder_task, "Driver Recorder");
@@ -0,0 +1,107 @@
+#include "main.h"
+
+cyclic_executive executive;
+
+const char* PHASE_NAMES[cyclic_executive::PHASES] = {"sense", "estimate", "control", "actuate"};
+
+cyclic_executive::cyclic_executive() {}
+
+bool cyclic_executive::add(e_phase phase, const char* name, std::function<void()> step) {
+  if (count >= MAX_STEPS) return false;
+
+  // Keep the steps sorted by phase, so a frame is one pass through them
+  int i = count;
+  while (i > 0 && steps[i - 1].phase > phase) {
+    steps[i] = steps[i - 1];
+    i--;
+  }
+  steps[i] = {phase, name, step, true};
+  count++;
+  return true;
+}
+
+void cyclic_executive::active_set(const char* name, bool input) {
+  for (int i = 0; i < count; i++)
+    if (strcmp(steps[i].name, name) == 0) steps[i].active = input;
+}
+
+bool cyclic_executive::active_get(const char* name) {
+  for (int i = 0; i < count; i++)
+    if (strcmp(steps[i].name, name) == 0) return steps[i].active;
+  return false;
+}
+
+void cyclic_executive::enable(bool input) { running = input; }
+
+bool cyclic_executive::enabled() { return running; }
+
+void cyclic_executive::period_set(okapi::QTime p_period) { period = std::max((int)p_period.convert(okapi::millisecond), 1); }
+
+int cyclic_executive::period_get() { return period; }
+
+int cyclic_executive::phase_time_get(e_phase phase) { return phase_time[phase]; }
+
+int cyclic_executive::phase_time_max_get(e_phase phase) { return phase_time_max[phase]; }
+
+int cyclic_executive::frame_time_get() { return frame_time; }
+
+int cyclic_executive::frame_time_max_get() { return frame_time_max; }
+
+int cyclic_executive::overruns_get() { return overruns; }
+
+void cyclic_executive::timing_reset() {
+  for (int i = 0; i < PHASES; i++)
+    phase_time_max[i] = 0;
+  frame_time_max = 0;
+  overruns = 0;
+}
+
+void cyclic_executive::print() {
+  printf("\nExecutive %s, %i ms frame\n", running ? "enabled" : "disabled", period);
+  for (int p = 0; p < PHASES; p++) {
+    printf("%-9s %6i us  max %6i us :", PHASE_NAMES[p], phase_time[p], phase_time_max[p]);
+    for (int i = 0; i < count; i++)
+      if (steps[i].phase == p) printf(" %s%s", steps[i].name, steps[i].active ? "" : " (off)");
+    printf("\n");
+  }
+  printf("frame     %6i us  max %6i us, %i overruns\n", frame_time, frame_time_max, overruns);
+}
+
+void cyclic_executive::iterate() {
+  std::uint64_t frame_start = pros::micros();
+  std::uint64_t phase_start = frame_start;
+  int i = 0;
+  for (int p = 0; p < PHASES; p++) {
+    for (; i < count && steps[i].phase == p; i++)
+      if (steps[i].active) steps[i].step();
+
+    std::uint64_t now = pros::micros();
+    phase_time[p] = now - phase_start;
+    phase_time_max[p] = std::max(phase_time_max[p], phase_time[p]);
+    phase_start = now;
+  }
+
+  frame_time = phase_start - frame_start;
+  frame_time_max = std::max(frame_time_max, frame_time);
+  if (frame_time > period * 1000) overruns++;
+}
+
+/**
+ * Runs a frame every period while the executive is enabled
+ */
+void executive_task() {
+  std::uint32_t last = pros::millis();
+  while (true) {
+    if (!executive.enabled()) {
+      pros::delay(ez::util::DELAY_TIME);
+      last = pros::millis();
+      continue;
+    }
+
+    executive.iterate();
+
+    // Frames start a fixed period apart no matter how long the last one took
+    pros::c::task_delay_until(&last, executive.period_get());
+  }
+}
+pros::Task executiveTask(executive_task, TASK_PRIORITY_DEFAULT + 1, TASK_STACK_DEPTH_DEFAULT, "Executive");
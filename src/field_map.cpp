@@ -0,0 +1,190 @@
+#include "main.h"
+#include "liblvgl/lvgl.h"
+
+field_map dashboard;
+
+// Size of the map on the screen, in pixels
+const lv_coord_t MAP_PX = 220;
+const lv_coord_t MAP_MARGIN = 10;
+const lv_coord_t ROBOT_PX = 10;
+const lv_coord_t HEADING_PX = 12;
+const lv_coord_t TRAIL_PX = 3;
+
+// How often the map updates, in ms
+const int FRAME_TIME = 40;
+
+// Lines keep a pointer to their points, so these have to stay put.  There's only one map
+static lv_point_t grid_points[10][2];
+static lv_point_t heading_points[2];
+static lv_point_t path_points[field_map::PATH_SIZE];
+
+field_map::field_map() {
+  for (int i = 0; i < TRAIL_SIZE; i++)
+    trail[i] = nullptr;
+}
+
+int field_map::x_px(double x) { return ez::util::clamp((x - X_MIN) / SIZE * MAP_PX, MAP_PX, 0); }
+
+int field_map::y_px(double y) { return MAP_PX - ez::util::clamp((y - Y_MIN) / SIZE * MAP_PX, MAP_PX, 0); }
+
+void field_map::initialize() {
+  if (screen != nullptr) return;
+
+  screen = lv_obj_create(NULL);
+  lv_obj_set_style_bg_color(screen, lv_color_black(), 0);
+  lv_obj_add_event_cb(
+      screen, [](lv_event_t* event) { ((field_map*)lv_event_get_user_data(event))->was_tapped = true; }, LV_EVENT_CLICKED, this);
+
+  map = lv_obj_create(screen);
+  lv_obj_remove_style_all(map);
+  lv_obj_set_size(map, MAP_PX, MAP_PX);
+  lv_obj_set_pos(map, MAP_MARGIN, MAP_MARGIN);
+  lv_obj_set_style_bg_color(map, lv_color_hex(0x404040), 0);
+  lv_obj_set_style_bg_opa(map, LV_OPA_COVER, 0);
+  lv_obj_clear_flag(map, LV_OBJ_FLAG_SCROLLABLE);
+  lv_obj_clear_flag(map, LV_OBJ_FLAG_CLICKABLE);
+
+  // Tile lines, they never move so they're only drawn when the map is shown
+  for (int i = 0; i < 5; i++) {
+    lv_coord_t p = MAP_PX * (i + 1) / 6;
+    grid_points[i][0] = {p, 0};
+    grid_points[i][1] = {p, MAP_PX};
+    grid_points[i + 5][0] = {0, p};
+    grid_points[i + 5][1] = {MAP_PX, p};
+  }
+  for (int i = 0; i < 10; i++) {
+    lv_obj_t* line = lv_line_create(map);
+    lv_line_set_points(line, grid_points[i], 2);
+    lv_obj_set_style_line_color(line, lv_color_hex(0x606060), 0);
+    lv_obj_set_style_line_width(line, 1, 0);
+  }
+
+  path = lv_line_create(map);
+  lv_obj_set_style_line_color(path, lv_color_hex(0x00A0FF), 0);
+  lv_obj_set_style_line_width(path, 2, 0);
+
+  for (int i = 0; i < TRAIL_SIZE; i++) {
+    trail[i] = lv_obj_create(map);
+    lv_obj_remove_style_all(trail[i]);
+    lv_obj_set_size(trail[i], TRAIL_PX, TRAIL_PX);
+    lv_obj_set_style_bg_color(trail[i], lv_color_hex(0xFFA000), 0);
+    lv_obj_set_style_bg_opa(trail[i], LV_OPA_COVER, 0);
+    lv_obj_clear_flag(trail[i], LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_add_flag(trail[i], LV_OBJ_FLAG_HIDDEN);
+  }
+
+  robot = lv_obj_create(map);
+  lv_obj_remove_style_all(robot);
+  lv_obj_set_size(robot, ROBOT_PX, ROBOT_PX);
+  lv_obj_set_style_bg_color(robot, lv_color_white(), 0);
+  lv_obj_set_style_bg_opa(robot, LV_OPA_COVER, 0);
+  lv_obj_clear_flag(robot, LV_OBJ_FLAG_CLICKABLE);
+
+  heading = lv_line_create(map);
+  lv_obj_set_style_line_color(heading, lv_color_hex(0xFF4040), 0);
+  lv_obj_set_style_line_width(heading, 2, 0);
+
+  label = lv_label_create(screen);
+  lv_obj_set_pos(label, MAP_PX + MAP_MARGIN * 2, MAP_MARGIN);
+  lv_obj_set_style_text_color(label, lv_color_white(), 0);
+  lv_label_set_text_static(label, "");
+
+  lv_timer_create([](lv_timer_t* timer) { ((field_map*)timer->user_data)->update(); }, FRAME_TIME, this);
+}
+
+void field_map::show(bool input) { requested = input; }
+
+bool field_map::showing() { return is_showing; }
+
+bool field_map::tapped() {
+  bool output = was_tapped;
+  was_tapped = false;
+  return output;
+}
+
+void field_map::bounds_set(okapi::QLength p_x_min, okapi::QLength p_y_min, okapi::QLength p_size) {
+  X_MIN = p_x_min.convert(okapi::inch);
+  Y_MIN = p_y_min.convert(okapi::inch);
+  SIZE = std::max(p_size.convert(okapi::inch), 1.0);
+  path_version = -1;
+}
+
+void field_map::trail_spacing_set(okapi::QLength p_spacing) { TRAIL_SPACING = p_spacing.convert(okapi::inch); }
+
+void field_map::trail_clear() { clear_trail = true; }
+
+void field_map::path_update() {
+  int version = pursuit.path_version_get();
+  if (version == path_version) return;
+
+  // Read straight out of the path buffer without copying it or taking its lock.  A
+  // new path landing part way through changes the version, and it's drawn next update
+  const path_buffer& points = pursuit.path_buffer_get();
+  int size = points.size();
+  int count = std::min(size, (int)PATH_SIZE);
+  for (int i = 0; i < count; i++) {
+    // Thin the path out evenly, always keeping the last point
+    int index = count > 1 ? (long)i * (size - 1) / (count - 1) : 0;
+    path_points[i] = {(lv_coord_t)x_px(points.x[index]), (lv_coord_t)y_px(points.y[index])};
+  }
+  if (pursuit.path_version_get() != version) return;
+  path_version = version;
+  lv_line_set_points(path, path_points, count);
+}
+
+void field_map::update() {
+  if (screen == nullptr) return;
+
+  // Showing and hiding happen here so the screen only changes in the LVGL task
+  if (requested != is_showing) {
+    if (requested) {
+      previous = lv_scr_act();
+      lv_scr_load(screen);
+    } else if (previous != nullptr) {
+      lv_scr_load(previous);
+    }
+    is_showing = requested;
+  }
+
+  if (clear_trail) {
+    for (int i = 0; i < TRAIL_SIZE; i++)
+      lv_obj_add_flag(trail[i], LV_OBJ_FLAG_HIDDEN);
+    trail_head = 0;
+    trail_last = {1000.0, 1000.0, 0.0};
+    clear_trail = false;
+  }
+
+  ez::pose pose = chassis.odom_pose_get();
+
+  // The trail is kept up while hidden, so it's complete when the map comes back
+  if (ez::util::distance_to_point(pose, trail_last) >= TRAIL_SPACING) {
+    trail_last = pose;
+    lv_obj_set_pos(trail[trail_head], x_px(pose.x) - TRAIL_PX / 2, y_px(pose.y) - TRAIL_PX / 2);
+    lv_obj_clear_flag(trail[trail_head], LV_OBJ_FLAG_HIDDEN);
+    trail_head = (trail_head + 1) % TRAIL_SIZE;
+  }
+
+  if (!is_showing) return;
+
+  path_update();
+
+  // Only move the robot when it's moved a whole pixel, so nothing is redrawn when it sits still
+  int x = x_px(pose.x);
+  int y = y_px(pose.y);
+  double angle = ez::util::to_rad(pose.theta);
+  int tip_x_new = x + HEADING_PX * sin(angle);
+  int tip_y_new = y - HEADING_PX * cos(angle);
+  if (x != robot_x || y != robot_y || tip_x_new != tip_x || tip_y_new != tip_y) {
+    robot_x = x;
+    robot_y = y;
+    tip_x = tip_x_new;
+    tip_y = tip_y_new;
+    lv_obj_set_pos(robot, x - ROBOT_PX / 2, y - ROBOT_PX / 2);
+    heading_points[0] = {(lv_coord_t)x, (lv_coord_t)y};
+    heading_points[1] = {(lv_coord_t)tip_x, (lv_coord_t)tip_y};
+    lv_line_set_points(heading, heading_points, 2);
+
+    snprintf(text, sizeof(text), "x: %.1f\ny: %.1f\na: %.1f", pose.x, pose.y, pose.theta);
+    lv_label_set_text_static(label, text);
+  }
+}
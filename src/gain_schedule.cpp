@@ -0,0 +1,151 @@
+#include "main.h"
+
+gain_schedule drive_forward_gains;
+gain_schedule drive_backward_gains;
+gain_schedule turn_gains;
+gain_schedule swing_gains;
+
+// Turn constants to put back once the scheduled turn is over
+bool turn_restore_pending = false;
+ez::PID::Constants turn_defaults;
+double turn_scheduled_target = 0.0;
+int turn_small_time = 0, turn_big_time = 0;
+pros::Mutex gain_lock;
+
+gain_schedule::gain_schedule() {}
+
+gain_schedule::gain_schedule(std::vector<point> points, e_index index) {
+  points_set(points, index);
+}
+
+void gain_schedule::points_set(std::vector<point> points, e_index index) {
+  std::sort(points.begin(), points.end(), [](const point& a, const point& b) { return a.key < b.key; });
+  table = points;
+  index_type = index;
+}
+
+std::vector<gain_schedule::point> gain_schedule::points_get() { return table; }
+
+gain_schedule::e_index gain_schedule::index_get() { return index_type; }
+
+bool gain_schedule::enabled() { return !table.empty(); }
+
+ez::PID::Constants gain_schedule::constants_get(double speed, double distance) {
+  double key = index_type == SPEED ? fabs(speed) : fabs(distance);
+
+  // Clamp to the ends of the table
+  if (key <= table.front().key) return table.front().constants;
+  if (key >= table.back().key) return table.back().constants;
+
+  // Find the two rows the key is between and blend them
+  for (size_t i = 1; i < table.size(); i++) {
+    if (key > table[i].key) continue;
+    const point& lo = table[i - 1];
+    const point& hi = table[i];
+    double t = (key - lo.key) / (hi.key - lo.key);
+    return {lo.constants.kp + (hi.constants.kp - lo.constants.kp) * t,
+            lo.constants.ki + (hi.constants.ki - lo.constants.ki) * t,
+            lo.constants.kd + (hi.constants.kd - lo.constants.kd) * t,
+            lo.constants.start_i + (hi.constants.start_i - lo.constants.start_i) * t};
+  }
+  return table.back().constants;
+}
+
+void pid_drive_scheduled_set(okapi::QLength p_target, int speed, bool slew_on, bool toggle_heading) {
+  double target = p_target.convert(okapi::inch);
+  bool backward = target < 0.0;
+
+  // Backward drives use the forward table unless they have their own
+  gain_schedule& gains = backward && drive_backward_gains.enabled() ? drive_backward_gains : drive_forward_gains;
+  if (!gains.enabled()) {
+    chassis.pid_drive_set(p_target, speed, slew_on, toggle_heading);
+    return;
+  }
+
+  // pid_drive_set() copies the forward or backward constants into leftPID and rightPID when the
+  // motion starts, so putting them back right after leaves only this motion on the scheduled ones
+  ez::PID::Constants defaults = backward ? chassis.pid_drive_constants_backward_get() : chassis.pid_drive_constants_forward_get();
+  ez::PID::Constants c = gains.constants_get(speed, target);
+  if (backward)
+    chassis.pid_drive_constants_backward_set(c.kp, c.ki, c.kd, c.start_i);
+  else
+    chassis.pid_drive_constants_forward_set(c.kp, c.ki, c.kd, c.start_i);
+
+  chassis.pid_drive_set(p_target, speed, slew_on, toggle_heading);
+
+  if (backward)
+    chassis.pid_drive_constants_backward_set(defaults.kp, defaults.ki, defaults.kd, defaults.start_i);
+  else
+    chassis.pid_drive_constants_forward_set(defaults.kp, defaults.ki, defaults.kd, defaults.start_i);
+}
+
+void pid_turn_scheduled_set(okapi::QAngle p_target, int speed, bool slew_on) {
+  if (!turn_gains.enabled()) {
+    chassis.pid_turn_set(p_target, speed, slew_on);
+    return;
+  }
+
+  // turnPID runs on the constants it's given, so they're put back by gain_schedule_iterate() once the turn is over
+  gain_lock.take();
+  if (!turn_restore_pending) turn_defaults = chassis.pid_turn_constants_get();
+  double distance = ez::util::wrap_angle(p_target.convert(okapi::degree) - chassis.drive_imu_get());
+  ez::PID::Constants c = turn_gains.constants_get(speed, distance);
+  chassis.pid_turn_constants_set(c.kp, c.ki, c.kd, c.start_i);
+
+  chassis.pid_turn_set(p_target, speed, slew_on);
+
+  turn_scheduled_target = chassis.turnPID.target;
+  turn_small_time = turn_big_time = 0;
+  turn_restore_pending = true;
+  gain_lock.give();
+}
+
+void pid_swing_scheduled_set(ez::e_swing type, okapi::QAngle p_target, int speed, int opposite_speed, bool slew_on) {
+  if (!swing_gains.enabled()) {
+    chassis.pid_swing_set(type, p_target, speed, opposite_speed, slew_on);
+    return;
+  }
+
+  // Like drives, pid_swing_set() copies the forward or backward constants into swingPID when the motion starts
+  ez::PID::Constants forward = chassis.pid_swing_constants_forward_get();
+  ez::PID::Constants backward = chassis.pid_swing_constants_backward_get();
+  double distance = ez::util::wrap_angle(p_target.convert(okapi::degree) - chassis.drive_imu_get());
+  ez::PID::Constants c = swing_gains.constants_get(speed, distance);
+  chassis.pid_swing_constants_set(c.kp, c.ki, c.kd, c.start_i);
+
+  chassis.pid_swing_set(type, p_target, speed, opposite_speed, slew_on);
+
+  chassis.pid_swing_constants_forward_set(forward.kp, forward.ki, forward.kd, forward.start_i);
+  chassis.pid_swing_constants_backward_set(backward.kp, backward.ki, backward.kd, backward.start_i);
+}
+
+void gain_schedule_iterate() {
+  gain_lock.take();
+  if (turn_restore_pending) {
+    // Settled the same way the turn's own exit condition does it
+    ez::PID::exit_condition_ exit = chassis.turnPID.exit;
+    double error = fabs(chassis.turnPID.error);
+    turn_small_time = error < exit.small_error ? turn_small_time + ez::util::DELAY_TIME : 0;
+    turn_big_time = error < exit.big_error ? turn_big_time + ez::util::DELAY_TIME : 0;
+    bool settled = (exit.small_exit_time > 0 && turn_small_time >= exit.small_exit_time) ||
+                   (exit.big_exit_time > 0 && turn_big_time >= exit.big_exit_time);
+
+    // Another motion started, or the turn is done
+    if (chassis.drive_mode_get() != ez::TURN || chassis.turnPID.target != turn_scheduled_target || settled) {
+      chassis.pid_turn_constants_set(turn_defaults.kp, turn_defaults.ki, turn_defaults.kd, turn_defaults.start_i);
+      turn_restore_pending = false;
+    }
+  }
+  gain_lock.give();
+}
+
+/**
+ * Puts the turn constants back after a scheduled turn every 10ms
+ */
+void gain_schedule_task() {
+  while (true) {
+    if (!executive.enabled()) gain_schedule_iterate();
+    pros::delay(ez::util::DELAY_TIME);
+  }
+}
+pros::Task gainScheduleTask(gain_schedule_task, "Gain Schedule");
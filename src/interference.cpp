@@ -0,0 +1,150 @@
+#include "main.h"
+
+interference_guard guard;
+
+// Below this the motors aren't being asked to do enough to be blocked, in volts
+const double MIN_VOLTAGE = 3.0;
+
+interference_guard::interference_guard() {}
+
+interference_guard::recovery interference_guard::back_off(okapi::QLength p_distance, int attempts) {
+  double distance = fabs(p_distance.convert(okapi::inch));
+  return [distance, attempts](int attempt) {
+    if (attempt >= attempts) return false;
+    chassis.pid_odom_set(-guard.direction_get() * distance * okapi::inch, 127);
+    guard.pid_wait();
+    return true;
+  };
+}
+
+interference_guard::recovery interference_guard::wiggle(okapi::QAngle p_angle, int attempts) {
+  double angle = fabs(p_angle.convert(okapi::degree));
+  return [angle, attempts](int attempt) {
+    if (attempt >= attempts) return false;
+    double heading = chassis.drive_imu_get();
+    for (double offset : {angle, -angle, 0.0}) {
+      chassis.pid_turn_set(heading + offset, 127);
+      guard.pid_wait();
+    }
+    return true;
+  };
+}
+
+interference_guard::recovery interference_guard::skip() {
+  return [](int attempt) { return false; };
+}
+
+void interference_guard::recovery_set(recovery input) { policy = input; }
+
+bool interference_guard::step(std::function<void()> motion) {
+  for (int attempt = 0;; attempt++) {
+    motion();
+    pid_wait();
+    if (!chassis.interfered) return true;
+
+    // Counted instead of printed, printing can block the auton on a full serial buffer
+    recoveries++;
+    if (!policy || !policy(attempt)) return false;
+  }
+}
+
+void interference_guard::clear() {
+  expected[0] = expected[1] = 0.0;
+  blocked_time = 0;
+  is_blocked = false;
+}
+
+void interference_guard::pid_wait() {
+  // The motion was just started, so whatever was seen before it doesn't count
+  clear();
+  chassis.interfered = false;
+  if (chassis.drive_mode_get() == ez::PURE_PURSUIT) {
+    chassis.pid_wait();
+    return;
+  }
+
+  bool print = chassis.pid_print_toggle_get();
+  while (true) {
+    ez::e_mode mode = chassis.drive_mode_get();
+    if (mode == ez::DISABLE || predict.exit_condition(mode, print)) break;
+
+    if (running && is_blocked) {
+      chassis.drive_mode_set(ez::DISABLE);
+      chassis.interfered = true;
+      clear();
+      break;
+    }
+    pros::delay(ez::util::DELAY_TIME);
+  }
+}
+
+void interference_guard::enable(bool input) { running = input; }
+
+bool interference_guard::enabled() { return running; }
+
+bool interference_guard::blocked() { return is_blocked; }
+
+int interference_guard::direction_get() { return direction; }
+
+int interference_guard::recoveries_get() { return recoveries; }
+
+void interference_guard::detection_set(double speed_ratio, int current_mA, okapi::QTime p_detect_time) {
+  SPEED_RATIO = ez::util::clamp(speed_ratio, 1.0, 0.0);
+  CURRENT_MA = abs(current_mA);
+  DETECT_TIME = p_detect_time.convert(okapi::millisecond);
+}
+
+void interference_guard::lag_set(okapi::QTime p_lag) { LAG = std::max(p_lag.convert(okapi::second), 0.01); }
+
+bool interference_guard::side_blocked(std::vector<pros::Motor>& motors, double& expected_rpm) {
+  double volts = 0.0, rpm = 0.0, mA = 0.0, free_rpm = 0.0;
+  for (auto& motor : motors) {
+    volts += motor.get_voltage() / 1000.0;
+    rpm += motor.get_actual_velocity();
+    mA += motor.get_current_draw();
+    pros::MotorGears gearing = motor.get_gearing();
+    free_rpm += gearing == pros::MotorGears::blue ? 600.0 : gearing == pros::MotorGears::red ? 100.0 : 200.0;
+  }
+  double n = motors.size();
+  volts /= n;
+  rpm /= n;
+  mA /= n;
+  free_rpm /= n;
+
+  // The speed this voltage should give, lagged by how long the robot takes to get there
+  double target_rpm = volts / 12.0 * free_rpm;
+  expected_rpm += (target_rpm - expected_rpm) * (ez::util::DELAY_TIME / 1000.0) / LAG;
+
+  if (fabs(volts) < MIN_VOLTAGE) return false;
+  int sign = volts > 0 ? 1 : -1;
+
+  // Spinning backwards against the voltage counts as no speed at all
+  double progress = std::max(rpm * sign, 0.0);
+  bool output = progress < fabs(expected_rpm) * SPEED_RATIO && mA > CURRENT_MA;
+  if (output) direction = sign;
+  return output;
+}
+
+void interference_guard::iterate() {
+  if (!running || chassis.drive_mode_get() == ez::DISABLE) {
+    clear();
+    return;
+  }
+
+  // Both sides are checked every tick so their expected speeds keep up
+  bool left = side_blocked(chassis.left_motors, expected[0]);
+  bool right = side_blocked(chassis.right_motors, expected[1]);
+  blocked_time = left || right ? blocked_time + ez::util::DELAY_TIME : 0;
+  is_blocked = blocked_time >= DETECT_TIME;
+}
+
+/**
+ * Watches the drive for blocks every 10ms
+ */
+void interference_task() {
+  while (true) {
+    if (!executive.enabled()) guard.iterate();
+    pros::delay(ez::util::DELAY_TIME);
+  }
+}
+pros::Task interferenceTask(interference_task, "Interference");
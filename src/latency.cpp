@@ -0,0 +1,127 @@
+#include "main.h"
+
+latency_compensation latency;
+
+// How much of each new speed is mixed into the filtered one
+const double VELOCITY_FILTER = 0.3;
+
+// Odom hasn't changed in this long, so the robot is sitting still, in microseconds
+const std::uint64_t STILL_TIME = 50000;
+
+// A wheel slower than this hasn't started moving yet, in rpm
+const double MOVING_RPM = 5.0;
+
+latency_compensation::latency_compensation() {}
+
+void latency_compensation::delay_set(okapi::QTime p_delay) { DELAY = std::max((int)p_delay.convert(okapi::millisecond), 0); }
+
+int latency_compensation::delay_get() { return DELAY; }
+
+void latency_compensation::enable(bool input) { running = input; }
+
+bool latency_compensation::enabled() { return running; }
+
+double latency_compensation::velocity_get() { return velocity; }
+
+double latency_compensation::angular_velocity_get() { return angular_velocity; }
+
+ez::pose latency_compensation::pose_predict(ez::pose current) {
+  if (!running || DELAY == 0) return current;
+
+  // Carry the pose along an arc, using the heading halfway through it
+  double dt = DELAY / 1000.0;
+  double turn = angular_velocity * dt;
+  double heading = ez::util::to_rad(current.theta + turn / 2.0);
+  double travel = velocity * dt;
+  return {current.x + travel * sin(heading), current.y + travel * cos(heading), current.theta + turn};
+}
+
+void latency_compensation::iterate() {
+  ez::pose current = chassis.odom_pose_get();
+  std::uint64_t now = pros::micros();
+
+  // Odom only updates in its own task, so a pose that hasn't changed isn't a new sample
+  bool moved = current.x != last_pose.x || current.y != last_pose.y || current.theta != last_pose.theta;
+  if (!moved) {
+    if (now - last_time > STILL_TIME) velocity = angular_velocity = 0.0;
+    return;
+  }
+
+  double dt = (now - last_time) / 1000000.0;
+  if (last_time != 0 && dt > 0.0) {
+    double heading = ez::util::to_rad(current.theta);
+    double along = (current.x - last_pose.x) * sin(heading) + (current.y - last_pose.y) * cos(heading);
+    velocity += (along / dt - velocity) * VELOCITY_FILTER;
+    angular_velocity += (ez::util::wrap_angle(current.theta - last_pose.theta) / dt - angular_velocity) * VELOCITY_FILTER;
+  }
+  last_pose = current;
+  last_time = now;
+}
+
+int latency_compensation::measure(int trials, int speed) {
+  chassis.drive_mode_set(ez::DISABLE);
+  pros::motor_brake_mode_e_t preference = chassis.drive_brake_get();
+  chassis.drive_brake_set(MOTOR_BRAKE_HOLD);
+  trials = std::max(trials, 1);
+
+  double total = 0.0;
+  int counted = 0;
+  printf("\n%5s %10s %10s %10s\n", "trial", "moving ms", "half ms", "rpm");
+  for (int t = 0; t < trials; t++) {
+    int direction = t % 2 == 0 ? 1 : -1;
+    chassis.drive_set(0, 0);
+    pros::delay(500);
+
+    // Every millisecond, the wheel speed along the step
+    const int SAMPLES = 600;
+    static float rpm[SAMPLES];
+    std::uint64_t start = pros::micros();
+    chassis.drive_set(speed * direction, speed * direction);
+    for (int i = 0; i < SAMPLES; i++) {
+      double left = chassis.left_motors[0].get_actual_velocity();
+      double right = chassis.right_motors[0].get_actual_velocity();
+      rpm[i] = (left + right) / 2.0 * direction;
+      pros::delay(1);
+    }
+    double elapsed = (pros::micros() - start) / 1000.0 / SAMPLES;
+    chassis.drive_set(0, 0);
+
+    // The last 100ms is the speed the step settles at
+    double settled = 0.0;
+    for (int i = SAMPLES - 100; i < SAMPLES; i++)
+      settled += rpm[i] / 100.0;
+
+    if (settled < MOVING_RPM) {
+      printf("%5i didn't move\n", t);
+      continue;
+    }
+
+    int moving = -1, half = -1;
+    for (int i = 0; i < SAMPLES && half < 0; i++) {
+      if (moving < 0 && rpm[i] > MOVING_RPM) moving = i;
+      if (rpm[i] >= settled / 2.0) half = i;
+    }
+    printf("%5i %10.1f %10.1f %10.1f\n", t, moving * elapsed, half * elapsed, settled);
+    total += half * elapsed;
+    counted++;
+  }
+  chassis.drive_brake_set(preference);
+  if (counted == 0) return DELAY;
+
+  // Odom is read up to a tick before it's used, half a tick on average
+  int measured = total / counted + ez::util::DELAY_TIME / 2.0;
+  printf("Latency: %i ms, set it with latency.delay_set(%i_ms)\n", measured, measured);
+  DELAY = measured;
+  return measured;
+}
+
+/**
+ * Tracks the robot's speed for latency compensation every 10ms
+ */
+void latency_task() {
+  while (true) {
+    if (!executive.enabled()) latency.iterate();
+    pros::delay(ez::util::DELAY_TIME);
+  }
+}
+pros::Task latencyTask(latency_task, "Latency");
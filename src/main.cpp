@@ -43,6 +43,7 @@ void initialize() {
   //  - change `left` to `right` if the tracking wheel is to the right of the centerline
   //  - ignore this if you aren't using a vertical tracker
   // chassis.odom_tracker_left_set(&vert_tracker);
+  // traction.tracker_set(&vert_tracker);  // Measures ground speed for traction control instead of the IMU
 
   // Configure your chassis controls
   chassis.opcontrol_curve_buttons_toggle(true);   // Enables modifying the controller curve with buttons on the joysticks
@@ -51,6 +52,56 @@ void initialize() {
 
   // Set the drive to your own constants from autons.cpp!
   default_constants();
+
+  // Sensors the sampler timestamps, the vertical tracker sends data every 5ms instead of 10ms
+  int left_drive = sampler.motor_add(chassis.left_motors[0], "left drive", 1.0 / chassis.drive_tick_per_inch());
+  int right_drive = sampler.motor_add(chassis.right_motors[0], "right drive", 1.0 / chassis.drive_tick_per_inch());
+  sampler.rotation_add(vert_tracker.smart_encoder, 5_ms, "vert tracker", 1.0 / vert_tracker.ticks_per_inch());
+  sampler.add([] { return chassis.drive_imu_get(); }, 10_ms, "imu");
+  sampler.add([] { int mm = rightDS.get_distance(); return mm == PROS_ERR ? PROS_ERR_F : mm; }, 33_ms, "right distance");
+  sampler.add([] { int mm = backDS.get_distance(); return mm == PROS_ERR ? PROS_ERR_F : mm; }, 33_ms, "back distance");
+  traction.wheel_channels_set(left_drive, right_drive);
+
+  // What telemetry can send and how often, telemetry.subscribe() changes the rate
+  telemetry.add("pose", "x,y,theta", [](float* v) {
+    ez::pose pose = chassis.odom_pose_get();
+    v[0] = pose.x, v[1] = pose.y, v[2] = pose.theta;
+  }, 20_ms);
+  telemetry.add("drive pid", "left error,left output,right error,right output", [](float* v) {
+    v[0] = chassis.leftPID.error, v[1] = chassis.leftPID.output, v[2] = chassis.rightPID.error, v[3] = chassis.rightPID.output;
+  }, 20_ms);
+  telemetry.add("turn pid", "error,output", [](float* v) { v[0] = chassis.turnPID.error, v[1] = chassis.turnPID.output; }, 20_ms);
+  telemetry.add("drive motors", "left mA,right mA,left rpm,right rpm", [](float* v) {
+    v[0] = chassis.left_motors[0].get_current_draw(), v[1] = chassis.right_motors[0].get_current_draw();
+    v[2] = chassis.left_motors[0].get_actual_velocity(), v[3] = chassis.right_motors[0].get_actual_velocity();
+  }, 50_ms);
+  telemetry.add("intake", "intake rpm,intake mA,top rpm,top mA,back rpm,back mA", [](float* v) {
+    v[0] = intake.get_actual_velocity(), v[1] = intake.get_current_draw();
+    v[2] = topintake.get_actual_velocity(), v[3] = topintake.get_current_draw();
+    v[4] = backintake.get_actual_velocity(), v[5] = backintake.get_current_draw();
+  }, 100_ms);
+  telemetry.add("interference", "blocked,recoveries", [](float* v) { v[0] = guard.blocked(), v[1] = guard.recoveries_get(); }, 100_ms);
+  telemetry.add("cpu", "load,least stack free", [](float* v) { v[0] = profiler.load_get(), v[1] = profiler.stack_free_min(); }, 1000_ms);
+  profiler.telemetry_add(1000_ms);  // CPU and stack free of every task, on its own channel
+
+  // What the cyclic executive runs each frame when it's enabled, in this order
+  //  - the sampler task still polls every 1ms, this poll catches anything that came in right before the frame
+  executive.add(cyclic_executive::SENSE, "sampler", [] { sampler.iterate(); });
+  executive.add(cyclic_executive::ESTIMATE, "thermal", [] { thermal.iterate(); });
+  executive.add(cyclic_executive::ESTIMATE, "interference", [] { guard.iterate(); });
+  executive.add(cyclic_executive::ESTIMATE, "latency", [] { latency.iterate(); });
+  executive.add(cyclic_executive::ESTIMATE, "events", [] { events.iterate(); });
+  executive.add(cyclic_executive::CONTROL, "gain schedule", [] { gain_schedule_iterate(); });
+  executive.add(cyclic_executive::CONTROL, "pursuit", [] { pursuit.iterate(); });
+  executive.add(cyclic_executive::CONTROL, "turn profile", [] { fast_turn.iterate(); });
+  executive.add(cyclic_executive::CONTROL, "boomerang", [] { fast_boomerang.iterate(); });
+  executive.add(cyclic_executive::CONTROL, "opcontrol", [] { opcontrol_iterate(); });
+  executive.add(cyclic_executive::ACTUATE, "traction", [] { traction.iterate(); });
+  executive.add(cyclic_executive::ACTUATE, "telemetry", [] { telemetry.iterate(); });
+  executive.active_set("opcontrol", false);  // Only runs during opcontrol()
+
+  // Route compiled with tools/route_compiler.cpp, copy a new one to the SD card to change it without uploading
+  sd_route.load("/usd/route.bin");
  
   // These are already defaulted to these buttons, but you can change the left/right curve buttons here!
   // chassis.opcontrol_curve_buttons_left_set(pros::E_CONTROLLER_DIGITAL_LEFT, pros::E_CONTROLLER_DIGITAL_RIGHT);  // If using tank, only the left side is used.
@@ -60,6 +111,15 @@ void initialize() {
   ez::as::auton_selector.autons_add({
        {"skillss sigma", fullSkills},
          {"Measure Offsets\n\nThis will turn the robot a bunch of times and calculate your offsets for your tracking wheels.", hi},
+         {"Measure Turn Limits\n\nSpins the robot at full power and brakes, then prints the limits for profiled turns.", measure_turn_limits},
+         {"Profiled Turn\n\nTurn 3 times with the measured turn limits.", profiled_turn_example},
+         {"Windowed Pursuit\n\nThe Pure Pursuit example's path, followed by the windowed pure pursuit follower.", windowed_pursuit_example},
+         {"Replay Driver\n\nReplays the last driving recorded in opcontrol with UP.", replay_driver},
+         {"Benchmark\n\nTimes EZ-Template's PID and slew and prints it to the terminal.", run_benchmarks},
+         {"Measure Latency\n\nSteps the drive back and forth and times how long the wheels take to respond.", measure_latency},
+         {"Measure Thermal\n\nStalls the intake for 3 minutes, lets it cool for 5, then prints the thermal model's constants.", measure_thermal},
+         {"Exit Simulation\n\nCompares normal and predicted exits on simulated motions in the terminal.", exit_simulation},
+         {"SD Card Route\n\nRuns route.bin from the SD card, made with tools/route_compiler.cpp.", sd_card_route},
      {"red", park},
      
     {"skills", skills},
@@ -84,10 +144,12 @@ void initialize() {
       {"Boomerang Pure Pursuit\n\nGo to (0, 24, 45) on the way to (24, 24) then come back to (0, 0, 0)", odom_boomerang_injected_pure_pursuit_example},
  */
   });
+  ez::as::auton_selector.autons_add(fullSkillsSegments());  // Run skills from any segment, odom is set to where that segment starts
 
   // Initialize chassis and auton selector
   chassis.initialize();
   ez::as::initialize();
+  dashboard.initialize();  // Field map, shown on the second blank page
   master.rumble(chassis.drive_imu_calibrated() ? "." : "---");
 }
 
@@ -125,6 +187,7 @@ void competition_initialize() {
  * from where it left off.
  */
 void autonomous() {
+  events.clear();                             // Drop events left over from a motion that never finished
   chassis.pid_targets_reset();                // Resets PID targets to 0
   chassis.drive_imu_reset();                  // Reset gyro position to 0
   chassis.drive_sensor_reset();               // Reset drive sensors to 0
@@ -144,20 +207,21 @@ void autonomous() {
   to be consistent
   */
 
+  bool driving = executive.active_get("opcontrol");
+  executive.active_set("opcontrol", false);       // Driver control doesn't run in the executive during autonomous
   ez::as::auton_selector.selected_auton_call();  // Calls selected auton from autonomous selector
+  executive.active_set("opcontrol", driving);     // Back to driver control when this was started from opcontrol
 }
 
 /**
  * Simplifies printing tracker values to the brain screen
  */
-void screen_print_tracker(ez::tracking_wheel *tracker, std::string name, int line) {
-  std::string tracker_value = "", tracker_width = "";
+void screen_print_tracker(ez::tracking_wheel *tracker, const char *name, int line) {
   // Check if the tracker exists
-  if (tracker != nullptr) {
-    tracker_value = name + " tracker: " + util::to_string_with_precision(tracker->get());             // Make text for the tracker value
-    tracker_width = "  width: " + util::to_string_with_precision(tracker->distance_to_center_get());  // Make text for the distance to center
-  }
-  ez::screen_print(tracker_value + tracker_width, line);  // Print final tracker text
+  if (tracker != nullptr)
+    brain_screen.print(line, "%s tracker: %.2f  width: %.2f", name, tracker->get(), tracker->distance_to_center_get());
+  else
+    brain_screen.clear(line);
 }
 
 /**
@@ -166,25 +230,62 @@ void screen_print_tracker(ez::tracking_wheel *tracker, std::string name, int lin
  * and will help you debug problems you're having
  */
 void ez_screen_task() {
+  bool was_on_page = false;
+  bool was_on_tasks = false;
   while (true) {
     // Only run this when not connected to a competition switch
     if (!pros::competition::is_connected()) {
       // Blank page for odom debugging
-      if (chassis.odom_enabled() && !chassis.pid_tuner_enabled()) {
-        // If we're on the first blank page...
-        if (ez::as::page_blank_is_on(0)) {
-          // Display X, Y, and Theta
-          ez::screen_print("x: " + util::to_string_with_precision(chassis.odom_x_get()) +
-                               "\ny: " + util::to_string_with_precision(chassis.odom_y_get()) +
-                               "\na: " + util::to_string_with_precision(chassis.odom_theta_get()),
-                           1);  // Don't override the top Page line
-
-          // Display all trackers that are being used
-          screen_print_tracker(chassis.odom_tracker_left, "l", 4);
-          screen_print_tracker(chassis.odom_tracker_right, "r", 5);
-          screen_print_tracker(chassis.odom_tracker_back, "b", 6);
-          screen_print_tracker(chassis.odom_tracker_front, "f", 7);
+      bool on_page = chassis.odom_enabled() && !chassis.pid_tuner_enabled() && ez::as::page_blank_is_on(0);
+
+      // The page was drawn over while it was away, so draw everything again
+      if (on_page && !was_on_page) brain_screen.invalidate();
+      was_on_page = on_page;
+
+      // If we're on the first blank page, only update at the screen's refresh rate
+      if (on_page && brain_screen.due()) {
+        // Display X, Y, and Theta, don't override the top Page line
+        brain_screen.print(1, "x: %.2f", chassis.odom_x_get());
+        brain_screen.print(2, "y: %.2f", chassis.odom_y_get());
+        brain_screen.print(3, "a: %.2f", chassis.odom_theta_get());
+
+        // Display all trackers that are being used
+        screen_print_tracker(chassis.odom_tracker_left, "l", 4);
+        screen_print_tracker(chassis.odom_tracker_right, "r", 5);
+        screen_print_tracker(chassis.odom_tracker_back, "b", 6);
+        screen_print_tracker(chassis.odom_tracker_front, "f", 7);
+
+        // Only lines that changed get sent to the screen
+        brain_screen.draw();
+      }
+
+      // Second blank page is the field map, tap the map to go back to the pages
+      bool on_map = chassis.odom_enabled() && !chassis.pid_tuner_enabled() && ez::as::page_blank_is_on(1);
+      if (on_map && dashboard.tapped()) {
+        ez::as::page_up();
+        on_map = false;
+      }
+      dashboard.show(on_map);
+
+      // Third blank page is the busiest tasks and how much stack they have left
+      bool on_tasks = !chassis.pid_tuner_enabled() && ez::as::page_blank_is_on(2);
+      if (on_tasks && !was_on_tasks) brain_screen.invalidate();
+      was_on_tasks = on_tasks;
+      if (on_tasks && brain_screen.due()) {
+        if (!profiler.available())
+          brain_screen.print(1, "No task stats in this kernel");
+        else if (profiler.runtime_available())
+          brain_screen.print(1, "cpu %.0f%%  %i tasks  least stack %i", profiler.load_get(), profiler.size(), profiler.stack_free_min());
+        else
+          brain_screen.print(1, "no cpu times  %i tasks  least stack %i", profiler.size(), profiler.stack_free_min());
+        for (int line = 2; line < screen_buffer::LINES; line++) {
+          task_profiler::task_stats task = profiler.get(line - 2);
+          if (task.alive)
+            brain_screen.print(line, "%-18.18s %5.1f%% %7i", task.name, task.cpu, task.stack_free);
+          else
+            brain_screen.clear(line);
         }
+        brain_screen.draw();
       }
     }
 
@@ -192,12 +293,13 @@ void ez_screen_task() {
     else {
       if (ez::as::page_blank_amount() > 0)
         ez::as::page_blank_remove_all();
+      dashboard.show(false);
     }
 
     pros::delay(ez::util::DELAY_TIME);
   }
 }
-pros::Task ezScreenTask(ez_screen_task);
+pros::Task ezScreenTask(ez_screen_task, "EZ Screen");
 
 /**
  * Gives you some extras to run in your opcontrol:
@@ -356,6 +458,8 @@ void backScore() {
 void opcontrol() {
   // This is preference to what you like to drive on
   chassis.drive_brake_set(MOTOR_BRAKE_COAST);
+  executive.active_set("opcontrol", true);
+  events.clear();
 
  
 
@@ -363,26 +467,69 @@ void opcontrol() {
     // Gives you some extras to make EZ-Template ezier
     ez_template_extras();
 
+    // Record driving to the SD card by pressing UP, and press it again to stop
+    //  - replay it with the "Replay Driver" auton
+    //  - the PID tuner navigates with the arrows, so UP doesn't record while it's open
+    if (!pros::competition::is_connected() && !chassis.pid_tuner_enabled() && master.get_digital_new_press(DIGITAL_UP)) {
+      if (driver.recording()) {
+        driver.record_stop();
+        master.rumble("..");
+      } else if (driver.record_start("/usd/driver.rec")) {
+        master.rumble(".");
+      }
+    }
+
+    // The executive runs driver control in its own frame when it's enabled
+    if (!executive.enabled()) opcontrol_iterate();
+    opcontrol_routine_run();
+
+    pros::delay(ez::util::DELAY_TIME);  // This is used for timer calculations!  Keep this ez::util::DELAY_TIME
+  }
+}
+
+// Routine queued by a button in opcontrol_iterate(), run by opcontrol_routine_run()
+void (*opcontrol_routine)() = nullptr;
+
+void opcontrol_routine_run() {
+  void (*routine)() = opcontrol_routine;
+  if (routine == nullptr) return;
+  opcontrol_routine = nullptr;
+
+  // The routine has the drive until it's done, the same as when it ran inside driver control
+  bool driving = executive.active_get("opcontrol");
+  executive.active_set("opcontrol", false);
+  routine();
+  executive.active_set("opcontrol", driving);
+}
+
+/**
+ * One tick of driver control.  Read the controller through driver instead of
+ * master so recordings replay through this same code.
+ */
+void opcontrol_iterate() {
+    driver.iterate();
+
     //chassis.pid_tuner_toggle();
 
-     if (master.get_digital(DIGITAL_B)) {
-          drive_example();
+     if (driver.get_digital(DIGITAL_B)) {
+          opcontrol_routine = drive_example;
         }
 
 
     
 
-    //chassis.opcontrol_tank();  // Tank control
-    chassis.opcontrol_arcade_standard(ez::SPLIT);   // Standard split arcade
-    // chassis.opcontrol_arcade_standard(ez::SINGLE);  // Standard single arcade
-    // chassis.opcontrol_arcade_flipped(ez::SPLIT);    // Flipped split arcade
-    // chassis.opcontrol_arcade_flipped(ez::SINGLE);   // Flipped single arcade
+    // Standard split arcade, the same as chassis.opcontrol_arcade_standard(ez::SPLIT)
+    //  - the curve buttons read master, so they're left out of replays
+    if (!driver.replaying()) chassis.opcontrol_curve_buttons_iterate();
+    double fwd_stick = chassis.opcontrol_curve_left(driver.get_analog(ANALOG_LEFT_Y));
+    double turn_stick = chassis.opcontrol_curve_right(driver.get_analog(ANALOG_RIGHT_X));
+    chassis.opcontrol_joystick_threshold_iterate(fwd_stick + turn_stick, fwd_stick - turn_stick);
 
     // . . .
     // Put more user control code here!
     // . . .
     
-    if (master.get_digital_new_press(DIGITAL_Y)) {
+    if (driver.get_digital_new_press(DIGITAL_Y)) {
       matchload.set(!matchload.get());
     } 
 /*
@@ -402,19 +549,19 @@ void opcontrol() {
            backScore();
         }
 */
-           if (master.get_digital(DIGITAL_X)) {
-           scoreX();
+           if (driver.get_digital(DIGITAL_X)) {
+           opcontrol_routine = scoreX;
         }
 
 
 
-     if (master.get_digital(DIGITAL_R1)) {
+     if (driver.get_digital(DIGITAL_R1)) {
             intake.move(-127);
             topintake.move(127);
               med.set(true);
              small.set(false);
         }
-        else if (master.get_digital(DIGITAL_R2)) {
+        else if (driver.get_digital(DIGITAL_R2)) {
             intake.move(-127);
             topintake.move(127);
              small.set(false);
@@ -422,13 +569,13 @@ void opcontrol() {
             
           
         }
-       else if ((master.get_digital(DIGITAL_L1))) {
+       else if ((driver.get_digital(DIGITAL_L1))) {
          intake.move(-127);
             topintake.move(127);
               med.set(false);
              small.set(true);
         }
-         else if ((master.get_digital(DIGITAL_L2))) {
+         else if ((driver.get_digital(DIGITAL_L2))) {
         intake.move(127);
             topintake.move(-127);
         }
@@ -441,12 +588,6 @@ void opcontrol() {
 /*  if (master.get_digital(DIGITAL_A)) {
             skills();
         }*/
-   
-
-    
-
-    pros::delay(ez::util::DELAY_TIME);  // This is used for timer calculations!  Keep this ez::util::DELAY_TIME
-  }
 }
 
 
@@ -0,0 +1,159 @@
+#include "main.h"
+
+motion_events events;
+
+motion_events::motion_events() {}
+
+bool motion_events::motion_key::operator==(const motion_key& other) const {
+  return mode == other.mode && followers == other.followers && path_version == other.path_version &&
+         std::equal(targets, targets + 4, other.targets);
+}
+
+motion_events::motion_key motion_events::key_get() {
+  int followers = pursuit.enabled() | fast_turn.enabled() << 1 | fast_boomerang.enabled() << 2;
+  return {chassis.drive_mode_get(), followers, pursuit.path_version_get(),
+          {chassis.leftPID.target, chassis.rightPID.target, chassis.turnPID.target, chassis.swingPID.target}};
+}
+
+void motion_events::motion_update() {
+  motion_key key = key_get();
+  if (key == last_key) return;
+
+  // Pursuit and profiled motions finish by giving EZ-Template the last point, that's still their motion
+  bool handed_off = last_key.followers != 0 && key.mode != ez::DISABLE;
+  last_key = key;
+  if (handed_off) return;
+
+  // Everything armed belongs to the motion that just ended
+  for (int i = 0; i < count; i++)
+    list[i].callback = nullptr;
+  count = 0;
+}
+
+bool motion_events::add(event input) {
+  events_lock.take();
+  // A motion started since the last tick has to be seen first, or this event would go with the one before it
+  motion_update();
+  bool added = count < MAX_EVENTS;
+  if (added) list[count++] = input;
+  events_lock.give();
+  return added;
+}
+
+bool motion_events::at_distance(okapi::QLength p_distance, std::function<void()> callback) {
+  event input;
+  input.trigger = DISTANCE;
+  input.value = fabs(p_distance.convert(okapi::inch));
+  input.start = traveled;
+  input.callback = callback;
+  return add(input);
+}
+
+bool motion_events::at_index(int index, std::function<void()> callback) {
+  event input;
+  input.trigger = INDEX;
+  input.value = index;
+  input.callback = callback;
+  return add(input);
+}
+
+bool motion_events::in_region(ez::united_pose center, okapi::QLength p_radius, std::function<void()> callback) {
+  event input;
+  input.trigger = REGION;
+  input.point = ez::util::united_pose_to_pose(center);
+  input.value = p_radius.convert(okapi::inch);
+  input.callback = callback;
+  return add(input);
+}
+
+bool motion_events::at_angle(okapi::QAngle p_angle, std::function<void()> callback) {
+  event input;
+  input.trigger = ANGLE;
+  input.value = p_angle.convert(okapi::degree);
+  input.last_error = ez::util::wrap_angle(input.value - chassis.drive_imu_get());
+  input.callback = callback;
+  return add(input);
+}
+
+bool motion_events::at_time(okapi::QTime p_time, std::function<void()> callback) {
+  event input;
+  input.trigger = TIME;
+  input.value = p_time.convert(okapi::millisecond);
+  input.start = pros::millis();
+  input.callback = callback;
+  return add(input);
+}
+
+void motion_events::clear() {
+  events_lock.take();
+  for (int i = 0; i < count; i++)
+    list[i].callback = nullptr;
+  count = 0;
+  events_lock.give();
+}
+
+int motion_events::armed() { return count; }
+
+bool motion_events::triggered(event& input, ez::pose current, double heading, int now) {
+  switch (input.trigger) {
+    case DISTANCE:
+      return traveled - input.start >= input.value;
+    case INDEX:
+      return pursuit.movement_index_get() >= input.value;
+    case REGION:
+      return ez::util::distance_to_point(input.point, current) <= input.value;
+    case ANGLE: {
+      // Fire when the heading gets close, or when it passes through the angle between ticks
+      double error = ez::util::wrap_angle(input.value - heading);
+      bool crossed = ez::util::sgn(error) != ez::util::sgn(input.last_error) && fabs(error) < 90.0;
+      input.last_error = error;
+      return fabs(error) <= 1.0 || crossed;
+    }
+    case TIME:
+      return now - input.start >= input.value;
+  }
+  return false;
+}
+
+void motion_events::iterate() {
+  ez::pose current = chassis.odom_pose_get();
+  traveled += ez::util::distance_to_point(current, last_pose);
+  last_pose = current;
+
+  events_lock.take();
+  motion_update();
+  events_lock.give();
+  if (count == 0) return;
+
+  double heading = chassis.drive_imu_get();
+  int now = pros::millis();
+  std::function<void()> fired[MAX_EVENTS];
+  int fired_count = 0;
+
+  // Pull out everything that triggered, keeping the rest in order
+  events_lock.take();
+  int kept = 0;
+  for (int i = 0; i < count; i++) {
+    if (triggered(list[i], current, heading, now))
+      fired[fired_count++] = std::move(list[i].callback);
+    else if (kept++ != i)
+      list[kept - 1] = std::move(list[i]);
+  }
+  count = kept;
+  events_lock.give();
+
+  // Callbacks run outside the lock so they can attach more events
+  for (int i = 0; i < fired_count; i++)
+    if (fired[i]) fired[i]();
+}
+
+/**
+ * Checks motion events every 10ms
+ */
+void motion_events_task() {
+  while (true) {
+    if (!executive.enabled()) events.iterate();
+    pros::delay(ez::util::DELAY_TIME);
+  }
+}
+pros::Task motionEventsTask(motion_events_task, "Motion Events");
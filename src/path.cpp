@@ -0,0 +1,109 @@
+#include "main.h"
+
+path_buffer::path_buffer(int capacity)
+    : x(new float[capacity]),
+      y(new float[capacity]),
+      theta(new float[capacity]),
+      speed(new float[capacity]),
+      look_ahead(new float[capacity]),
+      max_speed(new std::int16_t[capacity]),
+      direction(new std::uint8_t[capacity]),
+      turn_behavior(new std::uint8_t[capacity]),
+      scratch(new float[capacity]),
+      max_count(capacity) {}
+
+void path_buffer::clear() { count = 0; }
+
+bool path_buffer::push_back(const ez::odom& point) {
+  if (count >= max_count) return false;
+
+  x[count] = point.target.x;
+  y[count] = point.target.y;
+  theta[count] = point.target.theta == ez::ANGLE_NOT_SET ? NAN : point.target.theta;  // ANGLE_NOT_SET is too small for a float
+  speed[count] = point.max_xy_speed;
+  look_ahead[count] = 0.0f;
+  max_speed[count] = point.max_xy_speed;
+  direction[count] = point.drive_direction;
+  turn_behavior[count] = point.turn_behavior;
+  count++;
+  return true;
+}
+
+int path_buffer::size() const { return count; }
+
+int path_buffer::capacity() const { return max_count; }
+
+bool path_buffer::empty() const { return count == 0; }
+
+float path_buffer::distance_to(int index, ez::pose current) const {
+  float dx = x[index] - (float)current.x;
+  float dy = y[index] - (float)current.y;
+  return sqrtf(dx * dx + dy * dy);
+}
+
+float path_buffer::distance_between(int a, int b) const {
+  float dx = x[a] - x[b];
+  float dy = y[a] - y[b];
+  return sqrtf(dx * dx + dy * dy);
+}
+
+ez::pose path_buffer::pose_get(int index) const {
+  double t = std::isnan(theta[index]) ? ez::ANGLE_NOT_SET : theta[index];
+  return {x[index], y[index], t};
+}
+
+ez::odom path_buffer::odom_get(int index) const {
+  return {pose_get(index), (ez::drive_directions)direction[index], max_speed[index], (ez::e_angle_behavior)turn_behavior[index]};
+}
+
+std::vector<ez::odom> path_buffer::odoms_get() const {
+  std::vector<ez::odom> output;
+  output.reserve(count);
+  for (int i = 0; i < count; i++)
+    output.push_back(odom_get(i));
+  return output;
+}
+
+void path_buffer::smooth(double weight_smooth, double weight_data) {
+  if (count < 3 || weight_smooth <= 0.0) return;
+
+  // Direction changes split the path into pieces that are smoothed on their own
+  int start = 0;
+  for (int i = 1; i < count; i++) {
+    if (i == count - 1 || direction[i] != direction[i + 1]) {
+      smooth_segment(x.get(), start, i, weight_smooth, weight_data);
+      smooth_segment(y.get(), start, i, weight_smooth, weight_data);
+      start = i;
+    }
+  }
+}
+
+void path_buffer::smooth_segment(float* axis, int start, int end, double weight_smooth, double weight_data) {
+  if (end - start < 2) return;
+
+  // Gradient descent settles where every inside point satisfies
+  //   (weight_data + 2 * weight_smooth) * p[i] - weight_smooth * (p[i - 1] + p[i + 1]) = weight_data * original[i]
+  // which is tridiagonal, so it's solved with one forward and one backward pass
+  double a = -weight_smooth;
+  double b = weight_data + 2.0 * weight_smooth;
+  float* c_prime = scratch.get();
+
+  // Forward pass, the fixed ends are moved onto the right hand side
+  double c_last = 0.0;
+  double d_last = 0.0;
+  for (int i = start + 1; i < end; i++) {
+    double d = weight_data * axis[i];
+    if (i == start + 1) d -= a * axis[start];
+    if (i == end - 1) d -= a * axis[end];
+
+    double denom = b - a * c_last;
+    c_last = (i == end - 1) ? 0.0 : a / denom;
+    d_last = (d - a * d_last) / denom;
+    c_prime[i] = c_last;
+    axis[i] = d_last;  // Original value isn't needed again, so store d' in place
+  }
+
+  // Backward pass
+  for (int i = end - 2; i > start; i--)
+    axis[i] = axis[i] - c_prime[i] * axis[i + 1];
+}
@@ -0,0 +1,229 @@
+#include "main.h"
+
+predictive_exit predict;
+
+// A model that comes to rest slower than this per tick isn't trusted, it's still moving or holding speed
+const double SLOWEST_DECAY = 0.99;
+
+// Errors that change less than this over the whole window mean the robot is already at rest
+const double AT_REST = 0.001;
+
+predictive_exit::predictive_exit() {}
+
+// Solves the normal equations in m, the last column being the right hand side, for n unknowns
+static bool solve(double m[3][4], int n, double* out) {
+  double scale = 0.0;
+  for (int i = 0; i < n; i++)
+    scale += fabs(m[i][i]);
+
+  for (int col = 0; col < n; col++) {
+    int pivot = col;
+    for (int row = col + 1; row < n; row++)
+      if (fabs(m[row][col]) > fabs(m[pivot][col])) pivot = row;
+    if (fabs(m[pivot][col]) <= scale * 1e-9) return false;
+    for (int k = 0; k <= n; k++)
+      std::swap(m[col][k], m[pivot][k]);
+
+    for (int row = col + 1; row < n; row++) {
+      double factor = m[row][col] / m[col][col];
+      for (int k = col; k <= n; k++)
+        m[row][k] -= factor * m[col][k];
+    }
+  }
+
+  for (int row = n - 1; row >= 0; row--) {
+    double sum = m[row][n];
+    for (int k = row + 1; k < n; k++)
+      sum -= m[row][k] * out[k];
+    out[row] = sum / m[row][row];
+  }
+  return true;
+}
+
+double predictive_exit::at(int age) { return errors[(head - 1 - age + MAX_WINDOW) % MAX_WINDOW]; }
+
+bool predictive_exit::fit(int terms) {
+  // Each row predicts an error from the ones before it, terms - 1 of them and a constant
+  double m[3][4] = {};
+  int rows = count - (terms - 1);
+  for (int k = 0; k < rows; k++) {
+    double r[3] = {at(k + 1), terms == 3 ? at(k + 2) : 1.0, 1.0};
+    for (int i = 0; i < terms; i++) {
+      for (int j = 0; j < terms; j++)
+        m[i][j] += r[i] * r[j];
+      m[i][terms] += r[i] * at(k);
+    }
+  }
+
+  double x[3] = {0.0, 0.0, 0.0};
+  if (!solve(m, terms, x)) return false;
+  double a1 = x[0];
+  double a2 = terms == 3 ? x[1] : 0.0;
+  double c = x[terms - 1];
+
+  // The model has to settle, so both roots of z^2 - a1 z - a2 have to be inside SLOWEST_DECAY
+  double disc = a1 * a1 + 4.0 * a2;
+  double radius = disc >= 0.0 ? (fabs(a1) + sqrt(disc)) / 2.0 : sqrt(-a2);
+  if (radius >= SLOWEST_DECAY) return false;
+
+  double residual = 0.0;
+  for (int k = 0; k < rows; k++) {
+    double miss = at(k) - (a1 * at(k + 1) + a2 * (terms == 3 ? at(k + 2) : 0.0) + c);
+    residual += miss * miss;
+  }
+
+  // Misses in the fit carry through to where it rests, scaled by how slowly it gets there
+  double gain = 1.0 / (1.0 - a1 - a2);
+  prediction = c * gain;
+  uncertainty = CONFIDENCE * sqrt(residual / rows) * fabs(gain);
+  return true;
+}
+
+void predictive_exit::reset() {
+  head = 0;
+  count = 0;
+  confirmed = 0;
+  prediction = NAN;
+  uncertainty = NAN;
+}
+
+bool predictive_exit::update(double error, double tolerance) {
+  errors[head] = error;
+  head = (head + 1) % MAX_WINDOW;
+  count = std::min(count + 1, WINDOW);
+  if (count < WINDOW) return false;
+
+  double low = error, high = error;
+  for (int k = 1; k < count; k++) {
+    low = std::min(low, at(k));
+    high = std::max(high, at(k));
+  }
+
+  bool known = true;
+  if (high - low < AT_REST) {
+    prediction = error;
+    uncertainty = 0.0;
+  } else if (!fit(3) && !fit(2)) {
+    // A single decaying mode makes the second order fit singular, so the first order one is tried before giving up
+    prediction = uncertainty = NAN;
+    known = false;
+  }
+
+  if (known && fabs(prediction) + uncertainty <= tolerance)
+    confirmed++;
+  else
+    confirmed = 0;
+  return confirmed >= CONFIRM;
+}
+
+double predictive_exit::prediction_get() { return prediction; }
+
+double predictive_exit::uncertainty_get() { return uncertainty; }
+
+void predictive_exit::constants_set(int window, double confidence, int confirm) {
+  WINDOW = ez::util::clamp(window, MAX_WINDOW, 6);
+  CONFIDENCE = fabs(confidence);
+  CONFIRM = std::max(confirm, 1);
+}
+std::vector<double> predictive_exit::constants_get() { return {(double)WINDOW, CONFIDENCE, (double)CONFIRM}; }
+
+double predictive_exit::error_get(ez::e_mode mode) {
+  switch (mode) {
+    case ez::DRIVE:
+      return (chassis.leftPID.error + chassis.rightPID.error) / 2.0;
+    case ez::TURN:
+    case ez::TURN_TO_POINT:
+      return chassis.turnPID.error;
+    case ez::SWING:
+      return chassis.swingPID.error;
+    case ez::POINT_TO_POINT:
+      return chassis.xyPID.error;
+    default:
+      return NAN;
+  }
+}
+
+double predictive_exit::exit_error_get(ez::e_mode mode, bool big) {
+  ez::PID* pid = nullptr;
+  switch (mode) {
+    case ez::DRIVE:
+      pid = &chassis.leftPID;
+      break;
+    case ez::TURN:
+    case ez::TURN_TO_POINT:
+      pid = &chassis.turnPID;
+      break;
+    case ez::SWING:
+      pid = &chassis.swingPID;
+      break;
+    case ez::POINT_TO_POINT:
+      pid = &chassis.xyPID;
+      break;
+    default:
+      return 0.0;
+  }
+  return big ? std::max(pid->exit.big_error, pid->exit.small_error) : pid->exit.small_error;
+}
+
+bool predictive_exit::exit_condition(ez::e_mode mode, bool print) {
+  // The vector overloads take a copy of the vector, which allocates every tick, so the
+  // over current check looks at one motor.  Motors on a side are geared together and draw the same
+  pros::Motor& left_motor = chassis.left_motors[0];
+  pros::Motor& right_motor = chassis.right_motors[0];
+  switch (mode) {
+    case ez::DRIVE: {
+      // Both sides are checked every tick so their timers keep counting
+      bool left = chassis.leftPID.exit_condition(left_motor, print) != ez::RUNNING;
+      bool right = chassis.rightPID.exit_condition(right_motor, print) != ez::RUNNING;
+      return left && right;
+    }
+    case ez::TURN:
+    case ez::TURN_TO_POINT:
+      return chassis.turnPID.exit_condition(left_motor, print) != ez::RUNNING;
+    case ez::SWING:
+      // Only the swinging side is pushing
+      return chassis.swingPID.exit_condition(chassis.current_swing == ez::LEFT_SWING ? left_motor : right_motor, print) != ez::RUNNING;
+    case ez::POINT_TO_POINT: {
+      bool xy = chassis.xyPID.exit_condition(left_motor, print) != ez::RUNNING;
+      bool angle = chassis.current_a_odomPID.exit_condition(left_motor, print) != ez::RUNNING;
+      return xy && angle;
+    }
+    default:
+      return true;
+  }
+}
+
+void predictive_exit::pid_wait() {
+  int start = pros::millis();
+  last_predicted = false;
+  reset();
+
+  if (chassis.drive_mode_get() == ez::PURE_PURSUIT) {
+    chassis.pid_wait();
+    settle_time = pros::millis() - start;
+    return;
+  }
+
+  bool print = chassis.pid_print_toggle_get();
+  while (true) {
+    ez::e_mode mode = chassis.drive_mode_get();
+    if (mode == ez::DISABLE) break;
+
+    // The prediction only counts once the robot is close, so a fit made while speeding up can't end the motion
+    double error = error_get(mode);
+    bool settled = update(error, exit_error_get(mode, false));
+    if (settled && fabs(error) <= exit_error_get(mode, true)) {
+      last_predicted = true;
+      if (print) printf("  Predicted Exit, resting at %.2f\n", prediction);
+      break;
+    }
+    if (exit_condition(mode, print)) break;
+
+    pros::delay(ez::util::DELAY_TIME);
+  }
+  settle_time = pros::millis() - start;
+}
+
+int predictive_exit::settle_time_get() { return settle_time; }
+
+bool predictive_exit::predicted() { return last_predicted; }
@@ -0,0 +1,199 @@
+#include "main.h"
+
+task_profiler profiler;
+
+// The PROS kernel is built with these from FreeRTOS 10 but leaves them out of its
+// headers.  They're weak so a kernel built without them still links, and they're
+// null at run time instead
+extern "C" {
+typedef struct {
+  void* handle;
+  const char* name;
+  unsigned long number;
+  int state;
+  unsigned long priority;
+  unsigned long base_priority;
+  std::uint32_t runtime;
+  void* stack_base;
+  std::uint16_t stack_high_water;
+} freertos_task_status;
+
+unsigned long uxTaskGetSystemState(freertos_task_status* status, unsigned long size, std::uint32_t* total_runtime) __attribute__((weak));
+}
+
+// TaskStatus_t on the brain's 32 bit ARM, if this changes the struct above doesn't match it anymore
+#ifdef __arm__
+static_assert(sizeof(freertos_task_status) == 36, "freertos_task_status doesn't match the kernel's TaskStatus_t");
+#endif
+
+// Name FreeRTOS gives its idle task
+const char IDLE_NAME[] = "IDLE";
+
+task_profiler::task_profiler() {}
+
+void task_profiler::window_set(okapi::QTime p_window) { WINDOW = std::max((int)p_window.convert(okapi::millisecond), 100); }
+
+bool task_profiler::available() { return uxTaskGetSystemState != nullptr && layout_ok; }
+
+bool task_profiler::runtime_available() { return has_runtime; }
+
+double task_profiler::load_get() { return load; }
+
+int task_profiler::size() { return count; }
+
+task_profiler::task_stats task_profiler::get(int index) {
+  profiler_lock.take();
+  task_stats output = index >= 0 && index < count ? tasks[order[index]] : task_stats{""};
+  profiler_lock.give();
+  return output;
+}
+
+task_profiler::task_stats task_profiler::find(std::string name) {
+  profiler_lock.take();
+  task_stats output = {""};
+  for (int i = 0; i < count; i++)
+    if (name == tasks[i].name) output = tasks[i];
+  profiler_lock.give();
+  return output;
+}
+
+int task_profiler::stack_free_min() {
+  int least = INT_MAX;
+  for (int i = 0; i < count; i++)
+    if (tasks[i].alive) least = std::min(least, tasks[i].stack_free);
+  return least == INT_MAX ? 0 : least;
+}
+
+void task_profiler::print() {
+  if (!available()) {
+    printf(layout_ok ? "The kernel doesn't have task stats\n" : "The kernel's task stats don't match what the profiler expects\n");
+    return;
+  }
+  printf("\nLoad: %.1f%%%s\n", load, has_runtime ? "" : "  (no run time stats, only stack is measured)");
+  printf("%-24s %5s %7s %12s\n", "task", "prio", "cpu %", "stack free");
+  for (int i = 0; i < count; i++) {
+    task_stats task = get(i);
+    printf("%-24s %5i %7.1f %12i%s\n", task.name, task.priority, task.cpu, task.stack_free, task.alive ? "" : "  (ended)");
+  }
+}
+
+void task_profiler::telemetry_add(okapi::QTime p_rate) {
+  profiler_lock.take();
+  telemetry_rate = std::max((int)p_rate.convert(okapi::millisecond), 1);
+  for (int i = 0; i < count; i++) {
+    task_stats* task = &tasks[i];
+    telemetry.add(task->name, "cpu,stack free", [task](float* v) { v[0] = task->cpu, v[1] = task->stack_free; }, p_rate);
+  }
+  profiler_lock.give();
+}
+
+int task_profiler::slot(const char* name) {
+  for (int i = 0; i < count; i++)
+    if (strncmp(tasks[i].name, name, NAME_SIZE - 1) == 0) return i;
+  if (count >= MAX_TASKS) return -1;
+
+  task_stats& task = tasks[count];
+  snprintf(task.name, NAME_SIZE, "%s", name);
+  task.handle = nullptr;
+  task.cpu = 0.0;
+  order[count] = count;
+
+  // Names live in the slot, so the channel can keep pointing at them
+  if (telemetry_rate > 0)
+    telemetry.add(task.name, "cpu,stack free", [&task](float* v) { v[0] = task.cpu, v[1] = task.stack_free; }, telemetry_rate * okapi::millisecond);
+  return count++;
+}
+
+/**
+ * Checks what the kernel gave back against the public task API.  The count has to be what
+ * PROS counts, every priority has to be a real one, and the task asking has to be in there
+ * with its own name and priority.  None of this reads through a pointer from status, so a
+ * kernel with a different TaskStatus_t fails here instead of being read as garbage
+ */
+static bool layout_matches(freertos_task_status* status, int found, std::uint32_t before, std::uint32_t after) {
+  if (found < (int)std::min(before, after) || found > (int)std::max(before, after)) return false;
+
+  pros::task_t current = pros::c::task_get_current();
+  bool found_current = false;
+  for (int i = 0; i < found; i++) {
+    if (status[i].priority > TASK_PRIORITY_MAX) return false;
+    if (status[i].handle == current)
+      found_current = status[i].name == pros::c::task_get_name(current) && status[i].priority == pros::c::task_get_priority(current);
+  }
+  return found_current;
+}
+
+void task_profiler::sample() {
+  static freertos_task_status status[MAX_TASKS];
+  std::uint32_t total = 0;
+  std::uint32_t before = pros::c::task_get_count();
+  int found = uxTaskGetSystemState(status, MAX_TASKS, &total);
+  std::uint32_t after = pros::c::task_get_count();
+  if (found == 0) return;  // More tasks than status slots
+
+  if (!layout_matches(status, found, before, after)) {
+    layout_ok = false;
+    printf("The kernel's task stats don't match what the profiler expects, it's off\n");
+    return;
+  }
+
+  std::uint32_t elapsed = total - last_total;
+  has_runtime = total != 0;
+  last_total = total;
+
+  profiler_lock.take();
+  for (int i = 0; i < count; i++)
+    tasks[i].alive = false;
+
+  double idle = 0.0;
+  for (int i = 0; i < found; i++) {
+    // Tasks without a name would all share one slot
+    char name[NAME_SIZE];
+    if (status[i].name == nullptr || status[i].name[0] == '\0')
+      snprintf(name, NAME_SIZE, "task %p", status[i].handle);
+    else
+      snprintf(name, NAME_SIZE, "%s", status[i].name);
+    int index = slot(name);
+    if (index < 0) continue;
+    task_stats& task = tasks[index];
+
+    // A task made again under the same name starts counting from now
+    if (task.handle == status[i].handle && elapsed > 0)
+      task.cpu = 100.0 * (status[i].runtime - task.runtime) / elapsed;
+    else
+      task.cpu = 0.0;
+    task.handle = status[i].handle;
+    task.runtime = status[i].runtime;
+    task.priority = status[i].priority;
+    task.stack_free = status[i].stack_high_water * sizeof(std::uint32_t);
+    task.alive = true;
+    if (strcmp(task.name, IDLE_NAME) == 0) idle += task.cpu;
+  }
+  load = has_runtime ? 100.0 - idle : 0.0;
+
+  // Busiest first, tasks that ended go last
+  std::sort(order, order + count, [this](int a, int b) {
+    if (tasks[a].alive != tasks[b].alive) return tasks[a].alive;
+    return tasks[a].cpu > tasks[b].cpu;
+  });
+  profiler_lock.give();
+}
+
+void task_profiler::iterate() {
+  if (!available()) return;
+  std::uint32_t now = pros::millis();
+  if (now - last_sample < (std::uint32_t)WINDOW) return;
+  last_sample = now;
+  sample();
+}
+
+/**
+ * Measures every task once a window.  This runs even with the cyclic executive on, so it can measure it
+ */
+void profiler_task() {
+  while (true) {
+    profiler.iterate();
+    pros::delay(ez::util::DELAY_TIME);
+  }
+}
+pros::Task profilerTask(profiler_task, "Profiler");
@@ -0,0 +1,415 @@
+#include "main.h"
+
+pure_pursuit pursuit;
+
+pure_pursuit::pure_pursuit(int capacity) : path(capacity) {
+  grid.reserve(path.capacity());
+  injected_index.reserve(64);
+}
+
+// Track width used for steering when chassis.drive_width_get() hasn't been set
+const double DEFAULT_TRACK_WIDTH = 12.0;
+
+// Bends never slow the robot below this speed
+const double CURVE_MIN_SPEED = 30.0;
+
+void pure_pursuit::pid_pursuit_set(const std::vector<ez::odom>& imovements) {
+  if (imovements.empty()) return;
+
+  path_lock.take();
+  if (!inject(imovements)) {
+    path.clear();
+    injected_index.clear();
+    path_version++;
+    path_lock.give();
+
+    // Too many movements to give each one a point, EZ-Template can still drive them
+    printf("Pure pursuit path has more movements than points, driving it with pid_odom_set() instead\n");
+    running = false;
+    chain_pending = false;
+    chassis.pid_odom_set(imovements);
+    return;
+  }
+  path.smooth(SMOOTH_WEIGHT, SMOOTH_DATA);
+  profile();
+  grid_build();
+  closest_index = 0;
+  look_ahead_index = 0;
+
+  // Chained legs keep the robot's speed and look ahead from the last leg
+  if (!(running && chain_pending)) {
+    LOOK_AHEAD = LOOK_AHEAD_MIN;
+    velocity = 0.0;
+    last_pose = chassis.odom_pose_get();
+    last_time = pros::millis();
+  }
+  chain_pending = false;
+  path_version++;
+  path_lock.give();
+
+  // EZ-Template stays idle while this follower drives
+  chassis.drive_mode_set(ez::DISABLE, false);
+  running = true;
+}
+
+void pure_pursuit::pid_pursuit_set(const std::vector<ez::united_odom>& p_imovements) {
+  pid_pursuit_set(ez::util::united_odoms_to_odoms(p_imovements));
+}
+
+void pure_pursuit::pid_pursuit_set(const ez::united_odom& p_imovement) {
+  pid_pursuit_set(std::vector<ez::odom>{ez::util::united_odom_to_odom(p_imovement)});
+}
+
+ez::pose pure_pursuit::carrot_get(const ez::odom& movement, ez::pose from) {
+  double lead = std::min(ez::util::distance_to_point(movement.target, from) / 2.0, chassis.odom_boomerang_distance_get()) * chassis.odom_boomerang_dlead_get();
+  double away = movement.drive_direction == ez::rev ? lead : -lead;
+  ez::pose carrot = ez::util::vector_off_point(away, movement.target);
+  carrot.theta = ez::ANGLE_NOT_SET;
+  return carrot;
+}
+
+bool pure_pursuit::inject(const std::vector<ez::odom>& imovements) {
+  path.clear();
+  injected_index.clear();
+
+  ez::odom last = {chassis.odom_pose_get(), imovements[0].drive_direction, imovements[0].max_xy_speed};
+  last.target.theta = ez::ANGLE_NOT_SET;
+
+  // Spread points out further on paths too long to fit at the normal spacing.  Every segment,
+  // carrots included, can round up to one extra point, so those come out of the room first
+  double length = 0.0;
+  int segments = 0;
+  ez::pose previous = last.target;
+  for (auto& m : imovements) {
+    if (m.target.theta != ez::ANGLE_NOT_SET) {
+      ez::pose carrot = carrot_get(m, previous);
+      length += ez::util::distance_to_point(carrot, previous);
+      previous = carrot;
+      segments++;
+    }
+    length += ez::util::distance_to_point(m.target, previous);
+    previous = m.target;
+    segments++;
+  }
+  int room = path.capacity() - 1 - segments;
+  if (room < 1) return false;
+  double spacing = std::max(SPACING, length / room);
+
+  path.push_back(last);
+  for (auto& m : imovements) {
+    // Come into angled points from behind, like a boomerang carrot
+    if (m.target.theta != ez::ANGLE_NOT_SET) {
+      ez::pose carrot = carrot_get(m, last.target);
+      int n = std::max(1, (int)ceil(ez::util::distance_to_point(carrot, last.target) / spacing));
+      for (int k = 1; k <= n; k++) {
+        double t = (double)k / n;
+        ez::pose p = {last.target.x + (carrot.x - last.target.x) * t,
+                      last.target.y + (carrot.y - last.target.y) * t};
+        if (!path.push_back({p, m.drive_direction, m.max_xy_speed, m.turn_behavior})) return false;
+      }
+      last.target = carrot;
+    }
+
+    int n = std::max(1, (int)ceil(ez::util::distance_to_point(m.target, last.target) / spacing));
+    for (int k = 1; k <= n; k++) {
+      double t = (double)k / n;
+      ez::pose p = {last.target.x + (m.target.x - last.target.x) * t,
+                    last.target.y + (m.target.y - last.target.y) * t};
+      if (!path.push_back({p, m.drive_direction, m.max_xy_speed, m.turn_behavior})) return false;
+    }
+    // The final point keeps its angle so EZ-Template can boomerang into it
+    path.theta[path.size() - 1] = m.target.theta == ez::ANGLE_NOT_SET ? NAN : m.target.theta;
+    injected_index.push_back(path.size() - 1);
+    last = m;
+  }
+  return true;
+}
+
+double pure_pursuit::radius_at(int index, int span) {
+  int a = std::max(0, index - span);
+  int b = index;
+  int c = std::min(path.size() - 1, index + span);
+
+  // Radius of the circle through all three points, straight lines have no circle
+  double cross = (path.x[b] - path.x[a]) * (path.y[c] - path.y[a]) - (path.y[b] - path.y[a]) * (path.x[c] - path.x[a]);
+  if (fabs(cross) < 1e-6) return INFINITY;
+  return (path.distance_between(a, b) * path.distance_between(b, c) * path.distance_between(c, a)) / (2.0 * fabs(cross));
+}
+
+void pure_pursuit::profile() {
+  int size = path.size();
+
+  // Measure bends over the minimum look ahead, the robot can't follow anything tighter anyway
+  int span = std::max(1, (int)round(LOOK_AHEAD_MIN / SPACING));
+
+  for (int i = 0; i < size; i++) {
+    double radius = radius_at(i, span);
+    double max_speed = path.max_speed[i];
+    double speed = std::min(max_speed, CURVE_SPEED * radius);
+
+    // Slow down as much as allowed before changing direction
+    if (i < size - 1 && path.direction[i] != path.direction[i + 1])
+      speed = 0.0;
+
+    path.speed[i] = std::max(speed, std::min(CURVE_MIN_SPEED, max_speed));
+    path.look_ahead[i] = ez::util::clamp(radius, LOOK_AHEAD_MAX, LOOK_AHEAD_MIN);
+  }
+
+  // Ramp speed and look ahead down before bends instead of at them
+  for (int i = size - 2; i >= 0; i--) {
+    float d = path.distance_between(i, i + 1);
+    path.speed[i] = std::min(path.speed[i], path.speed[i + 1] + (float)CURVE_DECEL * d);
+    path.look_ahead[i] = std::min(path.look_ahead[i], path.look_ahead[i + 1] + d);
+  }
+}
+
+void pure_pursuit::velocity_update(ez::pose current) {
+  int now = pros::millis();
+  int dt = now - last_time;
+  if (dt <= 0) return;
+
+  double measured = ez::util::distance_to_point(current, last_pose) / (dt / 1000.0);
+  velocity = velocity * 0.7 + measured * 0.3;
+  last_pose = current;
+  last_time = now;
+}
+
+int pure_pursuit::grid_cell(double x, double y) {
+  int cx = (int)floor(x / GRID_SIZE) + 512;
+  int cy = (int)floor(y / GRID_SIZE) + 512;
+  return cx * 1024 + cy;
+}
+
+void pure_pursuit::grid_build() {
+  grid.clear();
+  for (int i = 0; i < path.size(); i++)
+    grid.push_back({grid_cell(path.x[i], path.y[i]), i});
+  std::sort(grid.begin(), grid.end());
+}
+
+int pure_pursuit::grid_rejoin(ez::pose current) {
+  int best_index = -1;
+  double best = REJOIN_DISTANCE * 2.0;
+
+  // Only look at the 3x3 cells around the robot, and never rejoin behind where we've been
+  for (int dx = -1; dx <= 1; dx++) {
+    for (int dy = -1; dy <= 1; dy++) {
+      int cell = grid_cell(current.x + dx * GRID_SIZE, current.y + dy * GRID_SIZE);
+      auto it = std::lower_bound(grid.begin(), grid.end(), std::make_pair(cell, 0));
+      for (; it != grid.end() && it->first == cell; it++) {
+        if (it->second < closest_index) continue;
+        double d = path.distance_to(it->second, current);
+        if (d < best) {
+          best = d;
+          best_index = it->second;
+        }
+      }
+    }
+  }
+  return best_index;
+}
+
+void pure_pursuit::closest_index_update(ez::pose current) {
+  int last = path.size() - 1;
+  int end = std::min(last, closest_index + WINDOW);
+  double best = path.distance_to(closest_index, current);
+
+  // Walk forward while points keep getting closer, never further than the window
+  while (closest_index < end) {
+    double next = path.distance_to(closest_index + 1, current);
+    if (next > best) break;
+    best = next;
+    closest_index++;
+  }
+
+  // The robot got pushed off the path, find where to rejoin it
+  if (best > REJOIN_DISTANCE) {
+    int rejoin = grid_rejoin(current);
+    if (rejoin > closest_index) closest_index = rejoin;
+  }
+}
+
+int pure_pursuit::look_ahead_index_find(ez::pose current) {
+  closest_index_update(current);
+
+  int last = path.size() - 1;
+  int i = std::max(look_ahead_index, closest_index);
+  std::uint8_t dir = path.direction[closest_index];
+
+  // Step back when the look ahead shrinks going into a bend
+  while (i > closest_index && path.distance_to(i - 1, current) >= LOOK_AHEAD)
+    i--;
+
+  // Don't look past a change in direction until the robot gets there
+  while (i < last && path.direction[i + 1] == dir && path.distance_to(i, current) < LOOK_AHEAD)
+    i++;
+
+  look_ahead_index = i;
+  return i;
+}
+
+void pure_pursuit::iterate() {
+  if (!running) return;
+
+  // Something else took over the drive
+  if (chassis.drive_mode_get() != ez::DISABLE) {
+    running = false;
+    return;
+  }
+
+  path_lock.take();
+  ez::pose current = chassis.odom_pose_get();
+  velocity_update(current);
+
+  // Steer from where the robot will be when this command reaches the wheels
+  current = latency.pose_predict(current);
+
+  // Look further ahead the faster the robot goes, up to what the bend allows
+  double velocity_ratio = ez::util::clamp(velocity / VELOCITY_MAX, 1.0, 0.0);
+  LOOK_AHEAD = LOOK_AHEAD_MIN + (path.look_ahead[closest_index] - LOOK_AHEAD_MIN) * velocity_ratio;
+
+  int i = look_ahead_index_find(current);
+  ez::odom target = path.odom_get(i);
+  double speed = path.speed[closest_index];
+
+  // A chained leg keeps driving at the end until the next leg starts, unless it's about to run past
+  bool at_end = i == path.size() - 1 && path.distance_to(i, current) < (chain_pending ? 1.0 : LOOK_AHEAD);
+  path_lock.give();
+
+  // Let EZ-Template settle the final point
+  if (at_end) {
+    // EZ-Template has the point before this stops, so motion events see one motion
+    chassis.pid_odom_set(target, false);
+    chain_pending = false;
+    running = false;
+    return;
+  }
+
+  // Put the look ahead point in the robot's frame, flipped when driving backwards
+  bool reversed = target.drive_direction == ez::rev;
+  double heading = ez::util::to_rad(current.theta + (reversed ? 180.0 : 0.0));
+  double dx = target.target.x - current.x;
+  double dy = target.target.y - current.y;
+  double local_x = dx * cos(heading) - dy * sin(heading);
+  double dist_sq = dx * dx + dy * dy;
+  double curvature = dist_sq > 0.0 ? 2.0 * local_x / dist_sq : 0.0;
+
+  double width = chassis.drive_width_get() > 0.0 ? chassis.drive_width_get() : DEFAULT_TRACK_WIDTH;
+  double left = speed * (1.0 + curvature * width / 2.0);
+  double right = speed * (1.0 - curvature * width / 2.0);
+
+  // Keep the ratio between sides but stay under max speed
+  double scale = std::max(fabs(left), fabs(right)) / speed;
+  if (speed > 0.0 && scale > 1.0) {
+    left /= scale;
+    right /= scale;
+  }
+
+  if (reversed)
+    chassis.drive_set(-right, -left);
+  else
+    chassis.drive_set(left, right);
+}
+
+void pure_pursuit::pid_wait() {
+  while (running)
+    pros::delay(ez::util::DELAY_TIME);
+  chassis.pid_wait();
+}
+
+void pure_pursuit::pid_wait_quick_chain() {
+  chain_pending = true;
+  while (running && path.distance_to(path.size() - 1, chassis.odom_pose_get()) > CHAIN_RADIUS)
+    pros::delay(ez::util::DELAY_TIME);
+
+  // EZ-Template already has the last point, so let it finish
+  if (!running) chassis.pid_wait();
+}
+
+void pure_pursuit::chain_radius_set(okapi::QLength p_radius) { CHAIN_RADIUS = p_radius.convert(okapi::inch); }
+double pure_pursuit::chain_radius_get() { return CHAIN_RADIUS; }
+
+void pure_pursuit::pid_wait_until_index(int index) {
+  if (index >= (int)injected_index.size() - 1) {
+    pid_wait();
+    return;
+  }
+  while (running && closest_index < injected_index[index])
+    pros::delay(ez::util::DELAY_TIME);
+}
+
+void pure_pursuit::stop() {
+  running = false;
+  chain_pending = false;
+  chassis.drive_set(0, 0);
+}
+
+bool pure_pursuit::enabled() { return running; }
+
+void pure_pursuit::look_ahead_set(okapi::QLength p_distance) { look_ahead_set(p_distance, p_distance); }
+void pure_pursuit::look_ahead_set(okapi::QLength p_min, okapi::QLength p_max) {
+  LOOK_AHEAD_MIN = p_min.convert(okapi::inch);
+  LOOK_AHEAD_MAX = std::max(LOOK_AHEAD_MIN, p_max.convert(okapi::inch));
+  LOOK_AHEAD = LOOK_AHEAD_MIN;
+}
+double pure_pursuit::look_ahead_get() { return LOOK_AHEAD; }
+std::vector<double> pure_pursuit::look_ahead_range_get() { return {LOOK_AHEAD_MIN, LOOK_AHEAD_MAX}; }
+
+void pure_pursuit::curve_speed_constant_set(double constant) { CURVE_SPEED = constant; }
+double pure_pursuit::curve_speed_constant_get() { return CURVE_SPEED; }
+
+void pure_pursuit::curve_decel_set(double speed_per_inch) { CURVE_DECEL = speed_per_inch; }
+double pure_pursuit::curve_decel_get() { return CURVE_DECEL; }
+
+void pure_pursuit::smooth_constants_set(double weight_smooth, double weight_data) {
+  SMOOTH_WEIGHT = weight_smooth;
+  SMOOTH_DATA = weight_data;
+}
+std::vector<double> pure_pursuit::smooth_constants_get() { return {SMOOTH_WEIGHT, SMOOTH_DATA}; }
+
+void pure_pursuit::velocity_max_set(double in_per_sec) { VELOCITY_MAX = in_per_sec; }
+double pure_pursuit::velocity_max_get() { return VELOCITY_MAX; }
+double pure_pursuit::velocity_get() { return velocity; }
+
+void pure_pursuit::spacing_set(okapi::QLength p_spacing) { SPACING = p_spacing.convert(okapi::inch); }
+double pure_pursuit::spacing_get() { return SPACING; }
+
+void pure_pursuit::window_set(int points) { WINDOW = std::max(1, points); }
+int pure_pursuit::window_get() { return WINDOW; }
+
+void pure_pursuit::rejoin_distance_set(okapi::QLength p_distance) { REJOIN_DISTANCE = p_distance.convert(okapi::inch); }
+double pure_pursuit::rejoin_distance_get() { return REJOIN_DISTANCE; }
+
+int pure_pursuit::closest_index_get() { return closest_index; }
+
+int pure_pursuit::movement_index_get() {
+  // Once EZ-Template has the last point, every movement has been passed
+  if (!running) return injected_index.size() - 1;
+
+  int index = -1;
+  while (index + 1 < (int)injected_index.size() && closest_index >= injected_index[index + 1])
+    index++;
+  return index;
+}
+
+std::vector<ez::odom> pure_pursuit::path_get() {
+  path_lock.take();
+  std::vector<ez::odom> output = path.odoms_get();
+  path_lock.give();
+  return output;
+}
+
+const path_buffer& pure_pursuit::path_buffer_get() { return path; }
+
+int pure_pursuit::path_version_get() { return path_version; }
+
+/**
+ * Runs the pure pursuit follower every 10ms
+ */
+void pursuit_task() {
+  while (true) {
+    if (!executive.enabled()) pursuit.iterate();
+    pros::delay(ez::util::DELAY_TIME);
+  }
+}
+pros::Task pursuitTask(pursuit_task, "Pursuit");
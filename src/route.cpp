@@ -0,0 +1,60 @@
+#include "main.h"
+
+route::segment::segment(const char* p_name, ez::united_pose p_start, std::function<void()> p_body)
+    : name(p_name), has_start(true), start(p_start), body(p_body) {}
+
+route::segment::segment(const char* p_name, std::function<void()> p_body)
+    : name(p_name), has_start(false), start({0_in, 0_in, 0_deg}), body(p_body) {}
+
+route::route(const char* p_name, std::vector<segment> p_segments) : name(p_name), segments(p_segments) {}
+
+int route::size() { return segments.size(); }
+
+std::string route::name_get(int index) { return index >= 0 && index < size() ? segments[index].name : ""; }
+
+bool route::start_known(int index) { return index >= 0 && index < size() && segments[index].has_start; }
+
+ez::united_pose route::start_get(int index) { return start_known(index) ? segments[index].start : ez::united_pose{0_in, 0_in, 0_deg}; }
+
+void route::segment_callback_set(std::function<void(int)> callback) { segment_callback = callback; }
+
+void route::start(int index) {
+  segment& leg = segments[index];
+  if (leg.has_start) chassis.odom_xyt_set(leg.start.x, leg.start.y, leg.start.theta);
+}
+
+void route::run_range(int from, int to) {
+  for (int i = from; i < to; i++) {
+    if (segment_callback) segment_callback(i);
+    segments[i].body();
+  }
+}
+
+void route::run() { run_range(0, size()); }
+
+void route::run_from(int index) {
+  if (index < 0 || index >= size()) return;
+  start(index);
+  run_range(index, size());
+}
+
+void route::run_segment(int index) {
+  if (index < 0 || index >= size()) return;
+  start(index);
+  run_range(index, index + 1);
+}
+
+std::vector<ez::Auton> route::autons_get() {
+  std::vector<ez::Auton> output;
+  for (int i = 1; i < size(); i++) {
+    segment& leg = segments[i];
+    char description[128];
+    if (leg.has_start)
+      snprintf(description, sizeof(description), "%s from %s\n\nStarts at (%.0f, %.0f, %.0f) and runs to the end.", name, leg.name,
+               leg.start.x.convert(okapi::inch), leg.start.y.convert(okapi::inch), leg.start.theta.convert(okapi::degree));
+    else
+      snprintf(description, sizeof(description), "%s from %s\n\nRuns from here to the end.", name, leg.name);
+    output.push_back(ez::Auton(description, [this, i] { run_from(i); }));
+  }
+  return output;
+}
@@ -0,0 +1,189 @@
+#include "main.h"
+
+using namespace route_format;
+
+route_bytecode sd_route;
+
+// Actuators by the number a route stores, in the same order as route_format::MOTORS and PISTONS
+pros::Motor* const ROUTE_MOTORS[MOTOR_COUNT] = {&intake, &topintake, &backintake};
+ez::Piston* const ROUTE_PISTONS[PISTON_COUNT] = {&matchload, &descore, &med, &small};
+
+route_bytecode::route_bytecode() { path.reserve(MAX_PATH); }
+
+bool route_bytecode::loaded() { return is_loaded; }
+
+int route_bytecode::size() { return is_loaded ? count : 0; }
+
+bool route_bytecode::load(std::string file) {
+  is_loaded = false;
+  if (!ez::util::SD_CARD_ACTIVE) return false;
+
+  FILE* input = fopen(file.c_str(), "rb");
+  if (input == nullptr) {
+    printf("No route at %s\n", file.c_str());
+    return false;
+  }
+  bytes = fread(buffer, 1, MAX_BYTES, input);
+  bool too_big = fgetc(input) != EOF;
+  fclose(input);
+
+  if (too_big) {
+    printf("%s is bigger than the %i byte route buffer\n", file.c_str(), MAX_BYTES);
+    return false;
+  }
+  if (!check()) {
+    printf("%s isn't a route, or it's damaged.  Compile it again\n", file.c_str());
+    return false;
+  }
+  is_loaded = true;
+  printf("Loaded %i instructions from %s\n", count, file.c_str());
+  return true;
+}
+
+bool route_bytecode::check() {
+  if (bytes < HEADER_SIZE || memcmp(buffer, MAGIC, 4) != 0 || buffer[4] != VERSION) return false;
+
+  std::uint32_t payload, expected;
+  std::uint16_t instructions;
+  memcpy(&instructions, &buffer[6], 2);
+  memcpy(&payload, &buffer[8], 4);
+  memcpy(&expected, &buffer[12], 4);
+  if (payload != (std::uint32_t)(bytes - HEADER_SIZE) || checksum(&buffer[HEADER_SIZE], payload) != expected) return false;
+
+  // Walk every instruction so a route can't run off the end of the buffer or use something that isn't plugged in
+  int offset = HEADER_SIZE, found = 0, points = 0;
+  while (offset < bytes) {
+    std::uint8_t op = buffer[offset];
+    if (op >= OP_COUNT || offset + op_size(op) > bytes) return false;
+    if (op == MOTOR && buffer[offset + 1] >= MOTOR_COUNT) return false;
+    if (op == PISTON && buffer[offset + 1] >= PISTON_COUNT) return false;
+    if (!angle_optional(op) && !angles_set(op, offset)) return false;
+    if (op == PATH_POINT && ++points > MAX_PATH) return false;
+    if (op == PATH_RUN) points = 0;
+    offset += op_size(op);
+    found++;
+  }
+  count = found;
+  return found == instructions;
+}
+
+bool route_bytecode::angles_set(std::uint8_t op, int offset) {
+  offset++;
+  for (const char* type = OPS[op].args; *type; type++) {
+    if (*type == 'a') {
+      std::int16_t value;
+      memcpy(&value, &buffer[offset], 2);
+      if (value == NO_ANGLE) return false;
+    }
+    offset += arg_size(*type);
+  }
+  return true;
+}
+
+int route_bytecode::decode(int offset, double* args) {
+  std::uint8_t op = buffer[offset++];
+  int n = 0;
+  for (const char* type = OPS[op].args; *type; type++) {
+    if (*type == 's') {
+      args[n++] = (std::int8_t)buffer[offset];
+    } else if (*type == 'f') {
+      args[n++] = buffer[offset];
+    } else if (*type == 't') {
+      std::uint16_t value;
+      memcpy(&value, &buffer[offset], 2);
+      args[n++] = value;
+    } else {
+      std::int16_t value;
+      memcpy(&value, &buffer[offset], 2);
+      if (*type == 'a')
+        args[n++] = value == NO_ANGLE ? ez::ANGLE_NOT_SET : value / ANGLE_SCALE;
+      else
+        args[n++] = value / DISTANCE_SCALE;
+    }
+    offset += arg_size(*type);
+  }
+  return offset;
+}
+
+void route_bytecode::execute(std::uint8_t op, double* args) {
+  // ez::e_mode has DRIVE, TURN and SWING too, so the opcodes are written out in full
+  switch (op) {
+    case route_format::POSE:
+      chassis.odom_xyt_set(args[0], args[1], args[2]);
+      break;
+    case route_format::DRIVE:
+      chassis.pid_drive_set(args[0], args[1], args[2]);
+      break;
+    case route_format::ODOM_DRIVE:
+      chassis.pid_odom_set(args[0], args[1], args[2]);
+      break;
+    case route_format::TURN:
+      chassis.pid_turn_set(args[0], args[1]);
+      break;
+    case route_format::SWING:
+      chassis.pid_swing_set(args[0] ? ez::RIGHT_SWING : ez::LEFT_SWING, args[1], (int)args[2], (int)args[3]);
+      break;
+    case route_format::POINT:
+      chassis.pid_odom_set({{args[0], args[1], args[2]}, args[3] ? ez::rev : ez::fwd, (int)args[4]}, args[5]);
+      break;
+    case route_format::PATH_POINT:
+      path.push_back({{args[0], args[1], args[2]}, args[3] ? ez::rev : ez::fwd, (int)args[4]});
+      break;
+    case route_format::PATH_RUN:
+      if (!path.empty()) chassis.pid_odom_set(path, args[0]);
+      path.clear();
+      break;
+    case route_format::WAIT:
+      chassis.pid_wait();
+      break;
+    case route_format::WAIT_QUICK:
+      chassis.pid_wait_quick();
+      break;
+    case route_format::WAIT_CHAIN:
+      chassis.pid_wait_quick_chain();
+      break;
+    case route_format::WAIT_UNTIL:
+      chassis.pid_wait_until(args[0]);
+      break;
+    case route_format::DELAY:
+      pros::delay(args[0]);
+      break;
+    case route_format::DRIVE_EXIT:
+      chassis.pid_drive_exit_condition_set(args[0], args[1], args[2], args[3], args[4], args[5]);
+      break;
+    case route_format::TURN_EXIT:
+      chassis.pid_turn_exit_condition_set(args[0], args[1], args[2], args[3], args[4], args[5]);
+      break;
+    case route_format::SWING_EXIT:
+      chassis.pid_swing_exit_condition_set(args[0], args[1], args[2], args[3], args[4], args[5]);
+      break;
+    case route_format::ODOM_EXIT:
+      chassis.pid_odom_drive_exit_condition_set(args[0], args[1], args[2], args[3], args[4], args[5]);
+      break;
+    case route_format::MOTOR:
+      ROUTE_MOTORS[(int)args[0]]->move(args[1]);
+      break;
+    case route_format::PISTON:
+      ROUTE_PISTONS[(int)args[0]]->set(args[1]);
+      break;
+    default:
+      break;
+  }
+}
+
+void route_bytecode::run() {
+  if (!is_loaded) {
+    printf("No route loaded\n");
+    return;
+  }
+
+  path.clear();
+  double args[MAX_ARGS];
+  int offset = HEADER_SIZE;
+  while (offset < bytes) {
+    std::uint8_t op = buffer[offset];
+    if (op == END) break;
+    offset = decode(offset, args);
+    execute(op, args);
+  }
+}
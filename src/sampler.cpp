@@ -0,0 +1,159 @@
+#include "main.h"
+
+sensor_sampler sampler;
+
+// How often every channel is polled, in ms
+const int POLL_TIME = 1;
+
+// Data periods without a new sample before a channel is stale
+const int STALE_PERIODS = 3;
+
+sensor_sampler::sensor_sampler() {}
+
+int sensor_sampler::add(channel_t input) {
+  sampler_lock.take();
+  int channel = count < MAX_CHANNELS ? count++ : -1;
+  if (channel >= 0) {
+    input.device_time = 0;
+    input.newest = {0.0, 0.0, 0.0, 0, 0, true};
+    input.duplicates = 0;
+    channels[channel] = input;
+  }
+  sampler_lock.give();
+  return channel;
+}
+
+int sensor_sampler::motor_add(pros::Motor motor, const char* name, double scale) {
+  channel_t input;
+  input.name = name;
+  input.timestamped = true;
+  input.rate = ez::util::DELAY_TIME;
+  input.read = [motor, scale](std::uint32_t* time) {
+    // The timestamp is read on both sides of the position, so they're from the same sample
+    std::uint32_t after = 0;
+    double position = PROS_ERR_F;
+    for (int tries = 0; tries < 3; tries++) {
+      motor.get_raw_position(time);
+      position = motor.get_position();
+      motor.get_raw_position(&after);
+      if (*time == after) break;
+    }
+    *time = after;
+    return position * scale;
+  };
+  return add(input);
+}
+
+int sensor_sampler::rotation_add(pros::Rotation sensor, okapi::QTime p_rate, const char* name, double scale) {
+  channel_t input;
+  input.name = name;
+  input.timestamped = false;
+  input.rate = std::max((int)p_rate.convert(okapi::millisecond), 5);
+  sensor.set_data_rate(input.rate);
+  input.read = [sensor, scale](std::uint32_t* time) {
+    std::int32_t position = sensor.get_position();
+    return position == PROS_ERR ? PROS_ERR_F : position * scale;
+  };
+  return add(input);
+}
+
+int sensor_sampler::add(std::function<double()> read, okapi::QTime p_rate, const char* name) {
+  channel_t input;
+  input.name = name;
+  input.timestamped = false;
+  input.rate = std::max((int)p_rate.convert(okapi::millisecond), 1);
+  input.read = [read](std::uint32_t* time) { return read(); };
+  return add(input);
+}
+
+sensor_sampler::sample sensor_sampler::get(int channel) {
+  sampler_lock.take();
+  sample output = channel >= 0 && channel < count ? channels[channel].newest : sample{0.0, 0.0, 0.0, 0, 0, true};
+  sampler_lock.give();
+  return output;
+}
+
+double sensor_sampler::value_get(int channel) { return get(channel).value; }
+
+double sensor_sampler::velocity_get(int channel) { return get(channel).velocity; }
+
+double sensor_sampler::dt_get(int channel) { return get(channel).dt; }
+
+bool sensor_sampler::stale(int channel) { return get(channel).stale; }
+
+int sensor_sampler::duplicates_get(int channel) { return channel >= 0 && channel < count ? channels[channel].duplicates : 0; }
+
+void sensor_sampler::print() {
+  printf("\n%-14s %6s %12s %12s %8s %10s\n", "channel", "rate", "value", "velocity", "dt ms", "repeats");
+  for (int i = 0; i < count; i++) {
+    sample newest = get(i);
+    printf("%-14s %6i %12.3f %12.3f %8.2f %10i%s\n", channels[i].name, channels[i].rate, newest.value, newest.velocity,
+           newest.dt * 1000.0, channels[i].duplicates, newest.stale ? "  STALE" : "");
+  }
+}
+
+void sensor_sampler::store(channel_t& input, double value, std::uint64_t time) {
+  sample& newest = input.newest;
+  double dt = (time - newest.time) / 1000000.0;
+  if (newest.sequence > 0 && dt > 0.0) {
+    newest.velocity = (value - newest.value) / dt;
+    newest.dt = dt;
+  }
+  newest.value = value;
+  newest.time = time;
+  newest.sequence++;
+  newest.stale = false;
+}
+
+void sensor_sampler::poll(channel_t& input, std::uint64_t now) {
+  std::uint32_t device_time = 0;
+  double value = input.read(&device_time);
+  sample& newest = input.newest;
+  std::uint64_t period = input.rate * 1000;
+
+  if (!std::isfinite(value)) {
+    newest.stale = true;
+    return;
+  }
+
+  if (newest.sequence == 0) {
+    input.device_time = device_time;
+    store(input, value, input.timestamped ? device_time * 1000ULL : now);
+  } else if (input.timestamped) {
+    // Motors say when their sample was taken, so a repeat is certain
+    if (device_time != input.device_time) {
+      input.device_time = device_time;
+      store(input, value, device_time * 1000ULL);
+    } else {
+      input.duplicates++;
+    }
+  } else if (value != newest.value) {
+    store(input, value, now);
+  } else if (now - newest.time >= 2 * period) {
+    // A whole period went by on top of the one this sample came in, so the sensor is sitting still
+    store(input, value, newest.time + period);
+  } else {
+    input.duplicates++;
+  }
+
+  if (now > newest.time + STALE_PERIODS * period) newest.stale = true;
+}
+
+void sensor_sampler::iterate() {
+  std::uint64_t now = pros::micros();
+  sampler_lock.take();
+  for (int i = 0; i < count; i++)
+    poll(channels[i], now);
+  sampler_lock.give();
+}
+
+/**
+ * Polls every sensor channel each millisecond
+ */
+void sampler_task() {
+  while (true) {
+    sampler.iterate();
+    pros::delay(POLL_TIME);
+  }
+}
+pros::Task samplerTask(sampler_task, "Sampler");
@@ -0,0 +1,51 @@
+#include "main.h"
+
+screen_buffer brain_screen;
+
+screen_buffer::screen_buffer() {
+  for (int i = 0; i < LINES; i++) {
+    pending[i][0] = '\0';
+    drawn[i][0] = '\0';
+    dirty[i] = false;
+  }
+}
+
+void screen_buffer::print(int line, const char* format, ...) {
+  if (line < 0 || line >= LINES) return;
+
+  va_list args;
+  va_start(args, format);
+  vsnprintf(pending[line], sizeof(pending[line]), format, args);
+  va_end(args);
+  dirty[line] = strcmp(pending[line], drawn[line]) != 0;
+}
+
+void screen_buffer::clear(int line) {
+  if (line < 0 || line >= LINES) return;
+  pending[line][0] = '\0';
+  dirty[line] = drawn[line][0] != '\0';
+}
+
+void screen_buffer::invalidate() {
+  // Whatever drew over the screen cleared it, so only lines with text need drawing
+  for (int i = 0; i < LINES; i++) {
+    drawn[i][0] = '\0';
+    dirty[i] = pending[i][0] != '\0';
+  }
+}
+
+bool screen_buffer::due() { return (int)pros::millis() - last_draw >= period; }
+
+void screen_buffer::draw() {
+  last_draw = pros::millis();
+  for (int i = 0; i < LINES; i++) {
+    if (!dirty[i]) continue;
+    pros::c::lcd_print(i, "%s", pending[i]);
+    memcpy(drawn[i], pending[i], sizeof(drawn[i]));
+    dirty[i] = false;
+  }
+}
+
+void screen_buffer::refresh_rate_set(double hz) { period = 1000.0 / std::max(hz, 1.0); }
+
+double screen_buffer::refresh_rate_get() { return 1000.0 / period; }
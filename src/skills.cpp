@@ -0,0 +1,104 @@
+#include "main.h"
+
+// Skills is in its own file so tools/route_segments.cpp can build its segments on a computer
+
+const int SWING_SPEED = 110;
+const int SKILLS_SPEED = 110;  // Same as normal in autons.cpp
+
+void fullSkillsMiddleGoal() {
+/*
+// pick up balls from park zone
+intake.move(-127);  topintake.move(127);
+chassis.pid_drive_set(65_in, 127, true); chassis.pid_wait();
+// move around inside the parkzone so balls can get picked up
+chassis.pid_turn_set(15_deg,90); chassis.pid_wait(); 
+chassis.pid_turn_set(-15_deg,90); chassis.pid_wait();
+chassis.pid_turn_set(15_deg,90); chassis.pid_wait(); 
+chassis.pid_turn_set(-15_deg,90); chassis.pid_wait();  
+chassis.pid_turn_set(0_deg,90); chassis.pid_wait(); */
+
+// leave park zone
+//chassis.pid_drive_set(-30_in, 110, true); chassis.pid_wait();
+//chassis.pid_drive_set(10_in, 70, true); chassis.pid_wait();
+// distance sensor reset
+intake.move(-127);  topintake.move(127);
+double parkAlign = (rightDS.get() / 24.0) - 70;
+chassis.odom_xyt_set(parkAlign, 24, 180);
+
+// align to middle goal
+chassis.pid_odom_set({{{-10_in, 56_in,150_deg}, rev, SKILLS_SPEED},}, true); chassis.pid_wait();
+chassis.pid_swing_set(ez::RIGHT_SWING, -135_deg, SWING_SPEED, 10); chassis.pid_wait();
+med.set(false); small.set(true);
+pros::delay(300);
+small.set(false);
+med.set(false);         
+// pick up 7th ball
+chassis.pid_drive_set(11_in, 60, true); chassis.pid_wait();
+chassis.pid_drive_set(-11_in, 60, true); chassis.pid_wait();
+// score middle goal 
+intake.move(-110); topintake.move(110);
+med.set(false); small.set(true);
+pros::delay(1000);
+intake.move(-60); topintake.move(60);
+pros::delay(1400);  
+// go back a little bit so when the triple stage flap closes it doesnt fling all the balls out    
+chassis.pid_drive_set(3_in, 60, true); chassis.pid_wait();
+med.set(false); small.set(false);
+}
+
+void fullSkillsMatchload() {
+// align to matchload and pick up the 3 blocks
+intake.move(-127); topintake.move(127);
+pursuit.pid_pursuit_set({{{-24_in, 48_in}, fwd, 110}, // pick up the 3 balls left in the 4 block square
+                         {{-24_in, 48_in}, fwd, 110}, // only here to drop the matchload
+                         {{-49_in, 27_in}, fwd, 110},});
+events.at_index(1, [] { matchload.set(true); }); // once it reaches -24, 48 drop matchload stopping the balls just picked up from escaping
+pursuit.pid_wait();
+
+chassis.pid_turn_set(180_deg,90); chassis.pid_wait();
+chassis.pid_drive_set(14_in, 110, true); chassis.pid_wait();
+
+pros::delay(1000);
+}
+
+void fullSkillsCrossField() {
+intake.move(-127); topintake.move(127);
+chassis.pid_odom_set({{{-49_in,24_in}, rev, 110}, // exit out of matchload
+                      {{-35_in, 48_in}, rev, 110},}, true);// begin travelling to the other side of the field
+chassis.pid_wait();
+chassis.pid_turn_set(180_deg,90); chassis.pid_wait();
+
+chassis.pid_odom_set(-60_in, 110, true); chassis.pid_wait(); 
+chassis.pid_turn_set(90_deg,90); chassis.pid_wait();
+
+double firstGoalAlign = ((backDS.get() / 24.0) - 23) * -1;
+chassis.pid_odom_set(firstGoalAlign, 110, true); chassis.pid_wait(); 
+//chassis.pid_odom_set({{{24_in, 108_in}, fwd, normal},},true);
+chassis.pid_turn_set(0_deg,90); chassis.pid_wait();
+chassis.pid_odom_set(-10_in, 110, true); chassis.pid_wait(); 
+med.set(true); small.set(false);
+pros::delay(2000);
+chassis.odom_xyt_set(-48_in,104_in,0_deg);
+}
+
+void fullSkillsLastGoal() {
+intake.move(-127); topintake.move(127);
+small.set(false);
+med.set(false);
+
+chassis.pid_odom_set({{{-47_in, 130_in}, fwd, SKILLS_SPEED},}, true); chassis.pid_wait();
+pros::delay(1000);
+chassis.pid_odom_set({{{-48_in, 104_in}, fwd, SKILLS_SPEED},}, true); chassis.pid_wait();
+med.set(true);
+small.set(false);
+}
+
+// Each segment starts where the one before it leaves the robot, so any of them can be run from the selector
+route fullSkillsRoute("skillss sigma", {{"middle goal", fullSkillsMiddleGoal},
+                                        {"matchload", {-11_in, 62.6_in, -135_deg}, fullSkillsMatchload},
+                                        {"cross field", {-49_in, 13_in, 180_deg}, fullSkillsCrossField},
+                                        {"last goal", {-48_in, 104_in, 0_deg}, fullSkillsLastGoal}});
+
+void fullSkills() { fullSkillsRoute.run(); }
+
+std::vector<ez::Auton> fullSkillsSegments() { return fullSkillsRoute.autons_get(); }
@@ -0,0 +1,184 @@
+#include "main.h"
+
+using namespace telemetry_format;
+
+telemetry_stream telemetry;
+
+// How often each channel is described again for a decoder that started late, in ms
+const std::uint32_t DESCRIBE_TIME = 2000;
+
+// Most the USB allowance can build up while there's nothing to send, in ms of bandwidth
+const int ALLOWANCE_TIME = 50;
+
+telemetry_stream::telemetry_stream() {}
+
+int telemetry_stream::add(const char* name, const char* values, std::function<void(float*)> read, okapi::QTime p_rate) {
+  int count = 1;
+  for (const char* c = values; *c; c++)
+    if (*c == ',') count++;
+  if (count > MAX_VALUES || strlen(name) + strlen(values) + 6 > MAX_FRAME) {
+    printf("Telemetry channel %s has too many values or too long a name\n", name);
+    return -1;
+  }
+
+  telemetry_lock.take();
+  int channel = channel_count < MAX_CHANNELS ? channel_count++ : -1;
+  if (channel >= 0) channels[channel] = {name, values, count, (int)p_rate.convert(okapi::millisecond), 0, 0, read};
+  telemetry_lock.give();
+  return channel;
+}
+
+int telemetry_stream::find(std::string name) {
+  for (int i = 0; i < channel_count; i++)
+    if (name == channels[i].name) return i;
+  return -1;
+}
+
+void telemetry_stream::subscribe(std::string name, okapi::QTime p_rate) {
+  int channel = find(name);
+  if (channel < 0) return;
+  telemetry_lock.take();
+  channels[channel].rate = std::max((int)p_rate.convert(okapi::millisecond), 1);
+  channels[channel].next_send = channels[channel].next_describe = pros::millis();
+  telemetry_lock.give();
+}
+
+void telemetry_stream::unsubscribe(std::string name) {
+  int channel = find(name);
+  if (channel >= 0) channels[channel].rate = 0;
+}
+
+void telemetry_stream::serial_set(int port, int baud) {
+  serial_port = port;
+  pros::c::serial_enable(port);
+  pros::c::serial_set_baudrate(port, baud);
+}
+
+void telemetry_stream::bandwidth_set(int bytes_per_second) { BANDWIDTH = std::max(bytes_per_second, 1); }
+
+void telemetry_stream::enable(bool input) {
+  if (input == running) return;
+
+  // The PROS stream headers would wrap every frame, so USB is read raw while streaming
+  if (serial_port == 0) pros::c::serctl(input ? SERCTL_DISABLE_COBS : SERCTL_ENABLE_COBS, nullptr);
+  telemetry_lock.take();
+  head = queued = 0;
+  allowance = 0.0;
+  last_flush = pros::millis();
+  for (int i = 0; i < channel_count; i++)
+    channels[i].next_send = channels[i].next_describe = last_flush;
+  running = input;
+  telemetry_lock.give();
+}
+
+bool telemetry_stream::enabled() { return running; }
+
+int telemetry_stream::dropped_get() { return dropped; }
+
+int telemetry_stream::queued_get() { return queued; }
+
+void telemetry_stream::queue(const std::uint8_t* frame, int size) {
+  std::uint8_t encoded[MAX_ENCODED + 1];
+  encoded[0] = 0;
+  int length = cobs_encode(frame, size, &encoded[1]) + 1;
+
+  // Whole frames or nothing, half a frame would only fail the CRC on the other end
+  if (queued + length > BUFFER_BYTES) {
+    dropped++;
+    return;
+  }
+  int tail = (head + queued) % BUFFER_BYTES;
+  for (int i = 0; i < length; i++)
+    buffer[(tail + i) % BUFFER_BYTES] = encoded[i];
+  queued += length;
+}
+
+void telemetry_stream::describe(int channel) {
+  channel_t& input = channels[channel];
+  std::uint8_t frame[MAX_FRAME];
+  int size = 0;
+  frame[size++] = DESCRIBE;
+  frame[size++] = channel;
+  frame[size++] = input.count;
+  for (const char* c = input.name; *c; c++)
+    frame[size++] = *c;
+  frame[size++] = 0;
+  for (const char* c = input.values; *c; c++)
+    frame[size++] = *c;
+  frame[size++] = 0;
+  frame[size] = crc8(frame, size);
+  queue(frame, size + 1);
+}
+
+void telemetry_stream::sample(int channel, std::uint32_t now) {
+  channel_t& input = channels[channel];
+  float values[MAX_VALUES] = {0};
+  input.read(values);
+
+  std::uint8_t frame[MAX_FRAME];
+  int size = 0;
+  frame[size++] = DATA;
+  frame[size++] = channel;
+  memcpy(&frame[size], &now, 4);
+  size += 4;
+  frame[size++] = input.count;
+  memcpy(&frame[size], values, input.count * sizeof(float));
+  size += input.count * sizeof(float);
+  frame[size] = crc8(frame, size);
+  queue(frame, size + 1);
+}
+
+void telemetry_stream::flush() {
+  std::uint32_t now = pros::millis();
+  allowance = std::min(allowance + BANDWIDTH * (now - last_flush) / 1000.0, BANDWIDTH * ALLOWANCE_TIME / 1000.0);
+  last_flush = now;
+
+  // Only send what fits, the rest waits for the next tick
+  int room = serial_port != 0 ? pros::c::serial_get_write_free(serial_port) : (int)allowance;
+  int length = std::min(std::max(room, 0), queued);
+  while (length > 0) {
+    int chunk = std::min(length, BUFFER_BYTES - head);
+    if (serial_port != 0) {
+      pros::c::serial_write(serial_port, &buffer[head], chunk);
+    } else {
+      fwrite(&buffer[head], 1, chunk, stdout);
+      allowance -= chunk;
+    }
+    head = (head + chunk) % BUFFER_BYTES;
+    queued -= chunk;
+    length -= chunk;
+  }
+  if (serial_port == 0) fflush(stdout);
+}
+
+void telemetry_stream::iterate() {
+  if (!running) return;
+
+  std::uint32_t now = pros::millis();
+  telemetry_lock.take();
+  for (int i = 0; i < channel_count; i++) {
+    channel_t& input = channels[i];
+    if (input.rate <= 0) continue;
+    if (now >= input.next_describe) {
+      describe(i);
+      input.next_describe = now + DESCRIBE_TIME;
+    }
+    if (now >= input.next_send) {
+      sample(i, now);
+      input.next_send = std::max(input.next_send + input.rate, now);
+    }
+  }
+  flush();
+  telemetry_lock.give();
+}
+
+/**
+ * Samples and sends telemetry every 10ms
+ */
+void telemetry_task() {
+  while (true) {
+    if (!executive.enabled()) telemetry.iterate();
+    pros::delay(ez::util::DELAY_TIME);
+  }
+}
+pros::Task telemetryTask(telemetry_task, "Telemetry");
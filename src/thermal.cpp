@@ -0,0 +1,247 @@
+#include "main.h"
+
+thermal_model thermal;
+
+// Motors report temperature in steps this wide, in degrees C
+const double TEMPERATURE_STEP = 5.0;
+
+// Most the current limit moves each tick, in mA
+const double LIMIT_SLEW = 20.0;
+
+thermal_model::thermal_model() { motors.reserve(MAX_MOTORS); }
+
+bool thermal_model::motor_add(pros::Motor motor, std::string name) { return add(motor, name, false); }
+
+bool thermal_model::add(pros::Motor motor, std::string name, bool drive) {
+  thermal_lock.take();
+  bool added = false;
+  if ((int)motors.size() < MAX_MOTORS && !find(name)) {
+    motor_state state = {motor, name, drive};
+    state.limit = MAX_MA;
+    state.saved_limit = drive ? chassis.drive_current_limit_get() : motor.get_current_limit();
+    state.applied_limit = state.saved_limit;
+    motors.push_back(state);
+    added = true;
+  }
+  thermal_lock.give();
+  return added;
+}
+
+void thermal_model::drive_add() {
+  int index = 0;
+  for (auto& motor : chassis.left_motors)
+    add(motor, "left " + std::to_string(index++), true);
+  index = 0;
+  for (auto& motor : chassis.right_motors)
+    add(motor, "right " + std::to_string(index++), true);
+}
+
+void thermal_model::enable(bool input) {
+  if (input == running) return;
+
+  thermal_lock.take();
+  if (input) {
+    drive_saved_limit = drive_applied_limit = chassis.drive_current_limit_get();
+    for (auto& state : motors) {
+      if (!state.drive) state.saved_limit = state.motor.get_current_limit();
+      state.applied_limit = state.drive ? drive_saved_limit : state.saved_limit;
+      state.limit = MAX_MA;
+      state.started = false;
+    }
+  } else {
+    for (auto& state : motors) {
+      if (!state.drive) state.motor.set_current_limit(state.saved_limit);
+      state.applied_limit = state.drive ? drive_saved_limit : state.saved_limit;
+    }
+    if (!traction.enabled()) chassis.drive_current_limit_set(drive_saved_limit);
+  }
+  running = input;
+  thermal_lock.give();
+}
+
+bool thermal_model::enabled() { return running; }
+
+void thermal_model::constants_set(double heating, double cooling) {
+  HEATING = fabs(heating);
+  COOLING = std::max(fabs(cooling), 0.0001);
+}
+std::vector<double> thermal_model::constants_get() { return {HEATING, COOLING}; }
+
+void thermal_model::derate_set(double limit, okapi::QTime p_horizon, int max_mA, int min_mA) {
+  LIMIT = limit;
+  HORIZON = std::max(p_horizon.convert(okapi::second), 1.0);
+  MAX_MA = abs(max_mA);
+  MIN_MA = std::min(abs(min_mA), MAX_MA);
+}
+
+thermal_model::motor_state* thermal_model::find(const std::string& name) {
+  for (auto& state : motors) {
+    if (state.name == name) return &state;
+  }
+  return nullptr;
+}
+
+double thermal_model::temperature_get(std::string name) {
+  motor_state* state = find(name);
+  return state ? state->temperature : 0.0;
+}
+
+double thermal_model::time_to_limit_get(std::string name) {
+  motor_state* state = find(name);
+  return state ? state->time_to_limit : INFINITY;
+}
+
+int thermal_model::current_limit_get(std::string name) {
+  motor_state* state = find(name);
+  return state ? state->applied_limit : 0;
+}
+
+// 2500 is the motor's own max, so nothing is taken away while disabled
+int thermal_model::drive_current_limit_get() { return running ? drive_applied_limit : 2500; }
+
+void thermal_model::update(motor_state& state, double dt) {
+  double reading = state.motor.get_temperature();
+  double amps = state.motor.get_current_draw() / 1000.0;
+  if (std::isinf(reading) || std::isnan(reading) || reading > 200.0) return;  // Unplugged
+
+  if (!state.started) {
+    state.ambient = reading;
+    state.temperature = reading;
+    state.started = true;
+  }
+
+  // Heat from current, cooling towards where the motor started
+  state.temperature += (HEATING * amps * amps - COOLING * (state.temperature - state.ambient)) * dt;
+
+  // Only correct when the estimate has left the step the motor is reporting
+  state.temperature = ez::util::clamp(state.temperature, reading + TEMPERATURE_STEP, reading);
+
+  // Where the motor would settle if it kept drawing this current, and how long until it crosses the limit
+  state.current = state.current * 0.98 + amps * 0.02;
+  double steady = state.ambient + HEATING * state.current * state.current / COOLING;
+  if (state.temperature >= LIMIT)
+    state.time_to_limit = 0.0;
+  else if (steady <= LIMIT)
+    state.time_to_limit = INFINITY;
+  else
+    state.time_to_limit = log((steady - state.temperature) / (steady - LIMIT)) / COOLING;
+
+  // Scale the limit down as the prediction comes inside the horizon, slewed so it's never a step
+  double ratio = ez::util::clamp(state.time_to_limit / HORIZON, 1.0, 0.0);
+  double target = MIN_MA + (MAX_MA - MIN_MA) * ratio;
+  state.limit += ez::util::clamp(target - state.limit, LIMIT_SLEW);
+}
+
+void thermal_model::iterate() {
+  int now = pros::millis();
+  double dt = (now - last_time) / 1000.0;
+  last_time = now;
+  if (!running || dt <= 0.0 || dt > 1.0) return;
+
+  thermal_lock.take();
+  int drive_limit = MAX_MA;
+  bool has_drive = false;
+  for (auto& state : motors) {
+    update(state, dt);
+    int limit = state.limit;
+
+    // The drive shares one limit so both sides stay matched
+    if (state.drive) {
+      drive_limit = std::min(drive_limit, limit);
+      has_drive = true;
+      state.applied_limit = limit;
+      continue;
+    }
+
+    // Only talk to the motor when the limit actually moves
+    if (abs(limit - state.applied_limit) >= 50) {
+      state.motor.set_current_limit(limit);
+      state.applied_limit = limit;
+    }
+  }
+  thermal_lock.give();
+
+  // Traction control folds this limit into its own while pushing
+  if (has_drive && abs(drive_limit - drive_applied_limit) >= 50) {
+    drive_applied_limit = drive_limit;
+    if (!traction.enabled()) chassis.drive_current_limit_set(drive_limit);
+  }
+}
+
+void thermal_model::constants_measure(pros::Motor motor, okapi::QTime p_heat, okapi::QTime p_cool) {
+  int heat_ms = std::max((int)p_heat.convert(okapi::millisecond), 1000);
+  int cool_ms = std::max((int)p_cool.convert(okapi::millisecond), 1000);
+  double start = motor.get_temperature();
+  if (std::isinf(start) || std::isnan(start) || start > 200.0) {
+    printf("Thermal: the motor isn't plugged in\n");
+    return;
+  }
+
+  // Once a second is plenty, the readings only move in steps
+  printf("\n%6s %8s %8s\n", "s", "C", "A");
+  double amps_squared = 0.0;
+  int samples = 0;
+  motor.move_voltage(12000);
+  for (int t = 1000; t <= heat_ms; t += 1000) {
+    pros::delay(1000);
+    double amps = motor.get_current_draw() / 1000.0;
+    amps_squared += amps * amps;
+    samples++;
+    printf("%6i %8.1f %8.2f\n", t / 1000, motor.get_temperature(), amps);
+  }
+  double peak = motor.get_temperature();
+  motor.move_voltage(0);
+  amps_squared /= std::max(samples, 1);
+
+  // When it last read a step lower while cooling
+  double cooled = peak;
+  int cooled_ms = 0;
+  for (int t = 1000; t <= cool_ms; t += 1000) {
+    pros::delay(1000);
+    double reading = motor.get_temperature();
+    printf("%6i %8.1f %8.2f\n", (heat_ms + t) / 1000, reading, 0.0);
+    if (reading < cooled) {
+      cooled = reading;
+      cooled_ms = t;
+    }
+  }
+
+  if (peak - start < 2.0 * TEMPERATURE_STEP || amps_squared <= 0.0) {
+    printf("Thermal: only heated %.0fC, run it longer or load it harder\n", peak - start);
+    return;
+  }
+  if (cooled_ms == 0) {
+    printf("Thermal: didn't cool a step, let it cool longer\n");
+    return;
+  }
+
+  // Cooling is exponential towards where it started.  Reading where it started means it's somewhere in that step
+  double above = std::max(cooled - start, TEMPERATURE_STEP / 2.0);
+  double cooling = log((peak - start) / above) / (cooled_ms / 1000.0);
+
+  // Heating at a steady current rises towards the steady temperature along the same exponential
+  double heating = (peak - start) * cooling / (amps_squared * (1.0 - exp(-cooling * heat_ms / 1000.0)));
+
+  constants_set(heating, cooling);
+  printf("Thermal constants: thermal.constants_set(%.4f, %.5f);\n", HEATING, COOLING);
+}
+
+void thermal_model::print() {
+  thermal_lock.take();
+  for (auto& state : motors) {
+    printf("%-8s %5.1fC  %6.1fs to limit  %4imA\n", state.name.c_str(), state.temperature,
+           std::isinf(state.time_to_limit) ? 999.9 : state.time_to_limit, state.applied_limit);
+  }
+  thermal_lock.give();
+}
+
+/**
+ * Runs the thermal model every 10ms
+ */
+void thermal_task() {
+  while (true) {
+    if (!executive.enabled()) thermal.iterate();
+    pros::delay(ez::util::DELAY_TIME);
+  }
+}
+pros::Task thermalTask(thermal_task, "Thermal");
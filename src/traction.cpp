@@ -0,0 +1,212 @@
+#include "main.h"
+
+traction_control traction;
+
+// Inches per second squared in one g
+const double GRAVITY = 386.09;
+
+// Wheel and IMU acceleration closer than this means the wheels have grip, in inches per second squared
+const double GRIP_ACCEL = 80.0;
+
+// Motors drawing under this share of the current limit can't push hard enough to slip
+const double GRIP_CURRENT = 0.4;
+
+// Longest the IMU is integrated without being pulled back onto the wheels before slip stops being
+// checked, in ms.  0.02g of bias only drifts 2.3 in/s in this long
+const int DRIFT_TIMEOUT = 300;
+
+// How long the robot has to be stuck before it counts as stalled, in ms
+const int STALL_TIMEOUT = 250;
+
+traction_control::traction_control() {}
+
+void traction_control::pid_push_set(okapi::QLength p_target, int speed, bool slew_on) {
+  enable(true);
+  chassis.pid_drive_set(p_target, speed, slew_on);
+}
+
+void traction_control::pid_wait() {
+  chassis.pid_wait();
+  enable(false);
+}
+
+void traction_control::enable(bool input) {
+  if (input == running) return;
+
+  if (input) {
+    saved_limit = chassis.drive_current_limit_get();
+    applied_limit = saved_limit;
+    grip_limit = MAX_MA;
+    stall_time = 0;
+  } else {
+    // Hand back to the thermal model if it's derating the drive
+    applied_limit = std::min(saved_limit, thermal.drive_current_limit_get());
+    chassis.drive_current_limit_set(applied_limit);
+  }
+  running = input;
+}
+
+bool traction_control::enabled() { return running; }
+
+void traction_control::current_limits_set(int max_mA, int min_mA, int stall_mA) {
+  MAX_MA = abs(max_mA);
+  MIN_MA = std::min(abs(min_mA), MAX_MA);
+  STALL_MA = ez::util::clamp(abs(stall_mA), MAX_MA, MIN_MA);
+}
+std::vector<int> traction_control::current_limits_get() { return {MAX_MA, MIN_MA, STALL_MA}; }
+
+void traction_control::thermal_constants_set(double limit, double range) {
+  TEMP_LIMIT = limit;
+  TEMP_RANGE = std::max(fabs(range), 1.0);
+}
+
+void traction_control::slip_constants_set(double slip_tolerance, int step) {
+  SLIP_TOLERANCE = fabs(slip_tolerance);
+  SLIP_STEP = abs(step);
+}
+
+void traction_control::imu_axis_set(e_axis axis, bool reversed) {
+  imu_axis = axis;
+  imu_reversed = reversed;
+}
+
+void traction_control::wheel_channels_set(int left, int right) {
+  left_channel = left;
+  right_channel = right;
+}
+
+void traction_control::tracker_set(ez::tracking_wheel* tracker) {
+  ground_tracker = tracker;
+  if (tracker != nullptr) last_tracker_position = tracker->get();
+}
+
+double traction_control::thermal_headroom_get() { return headroom; }
+
+int traction_control::current_get() { return current; }
+
+int traction_control::current_limit_get() { return applied_limit; }
+
+double traction_control::slip_get() { return ground_known() ? wheel_velocity - ground_velocity : 0.0; }
+
+bool traction_control::ground_known() { return ground_tracker != nullptr || drift_time < DRIFT_TIMEOUT; }
+
+bool traction_control::stalled() { return stall_time >= STALL_TIMEOUT; }
+
+double traction_control::wheel_position_get() {
+  // Always the motor encoders, even with tracking wheels, so slip shows up
+  double left = chassis.left_motors.front().get_position();
+  double right = chassis.right_motors.front().get_position();
+  return ((left + right) / 2.0) / chassis.drive_tick_per_inch();
+}
+
+double traction_control::imu_accel_get() {
+  pros::imu_accel_s_t accel = chassis.imu.get_accel();
+  double forward = imu_axis == X_AXIS ? accel.x : accel.y;
+  return (imu_reversed ? -forward : forward) * GRAVITY;
+}
+
+void traction_control::iterate() {
+  int now = pros::millis();
+  int dt_ms = now - last_time;
+  if (dt_ms <= 0) return;
+
+  // Nothing to measure velocity against yet
+  if (last_time == 0) {
+    last_position = wheel_position_get();
+    last_time = now;
+    return;
+  }
+
+  double dt = dt_ms / 1000.0;
+  last_time = now;
+
+  // Hottest motor and total draw across both sides
+  double hottest = 0.0;
+  current = 0;
+  for (auto side : {&chassis.left_motors, &chassis.right_motors}) {
+    for (auto& motor : *side) {
+      for (double temp : motor.get_temperature_all())
+        hottest = std::max(hottest, temp);
+      for (std::int32_t draw : motor.get_current_draw_all())
+        current += abs(draw);
+    }
+  }
+  headroom = TEMP_LIMIT - hottest;
+
+  // Wheel speed from the motors
+  double position = wheel_position_get();
+  double last_wheel_velocity = wheel_velocity;
+  if (left_channel >= 0 && right_channel >= 0)
+    wheel_velocity = (sampler.velocity_get(left_channel) + sampler.velocity_get(right_channel)) / 2.0;
+  else
+    wheel_velocity = (position - last_position) / dt;
+  last_position = position;
+  ground_velocity_update(imu_accel_get(), (wheel_velocity - last_wheel_velocity) / dt, dt);
+
+  if (!running) return;
+
+  // Pull current back as the motors run out of thermal headroom
+  double thermal_ratio = ez::util::clamp(headroom / TEMP_RANGE, 1.0, 0.0);
+  int thermal_limit = MIN_MA + (MAX_MA - MIN_MA) * thermal_ratio;
+
+  // Step down while the wheels spin out, and recover once they grip.  Without a ground speed to
+  // trust slip_get() is 0, so the limit recovers instead of chasing IMU drift
+  if (fabs(slip_get()) > SLIP_TOLERANCE)
+    grip_limit = std::max(grip_limit - SLIP_STEP, MIN_MA);
+  else
+    grip_limit = std::min(grip_limit + SLIP_STEP / 2, MAX_MA);
+
+  // Stuck against something with the motors working hard
+  int motor_count = chassis.left_motors.size() + chassis.right_motors.size();
+  bool working = current / std::max(motor_count, 1) > applied_limit * 0.8;
+  if (working && fabs(wheel_velocity) < 2.0)
+    stall_time += dt_ms;
+  else
+    stall_time = 0;
+
+  int limit = std::min({thermal_limit, grip_limit, thermal.drive_current_limit_get()});
+  if (stalled()) limit = std::min(limit, STALL_MA);
+
+  // Only talk to the motors when the limit actually moves
+  if (abs(limit - applied_limit) >= 50) {
+    chassis.drive_current_limit_set(limit);
+    applied_limit = limit;
+  }
+}
+
+void traction_control::ground_velocity_update(double imu_accel, double wheel_accel, double dt) {
+  // A tracking wheel doesn't slip, so it is the ground speed
+  if (ground_tracker != nullptr) {
+    double position = ground_tracker->get();
+    ground_velocity = (position - last_tracker_position) / dt;
+    last_tracker_position = position;
+    return;
+  }
+
+  // The IMU drifts when integrated, so it's pulled back onto the wheels, but only when
+  // something other than the two agreeing says the wheels have grip.  Wheels spinning
+  // out at a steady speed have no acceleration either
+  // out at a steady speed have no acceleration either.  A push never gets that light, so
+  // after DRIFT_TIMEOUT without being pulled back the estimate stops being used
+  ground_velocity += imu_accel * dt;
+  int motor_count = chassis.left_motors.size() + chassis.right_motors.size();
+  bool light_load = current / std::max(motor_count, 1) < applied_limit * GRIP_CURRENT;
+  if (light_load && fabs(wheel_accel - imu_accel) < GRIP_ACCEL) {
+    // An estimate that drifted for too long starts over from the wheels
+    ground_velocity = ground_known() ? ground_velocity * 0.9 + wheel_velocity * 0.1 : wheel_velocity;
+    drift_time = 0;
+  } else {
+    drift_time = std::min(drift_time + (int)(dt * 1000.0), DRIFT_TIMEOUT);
+  }
+}
+
+/**
+ * Runs traction control every 10ms
+ */
+void traction_task() {
+  while (true) {
+    if (!executive.enabled()) traction.iterate();
+    pros::delay(ez::util::DELAY_TIME);
+  }
+}
+pros::Task tractionTask(traction_task, "Traction");
@@ -0,0 +1,171 @@
+#include "main.h"
+
+turn_profile fast_turn;
+
+// Least acceleration and braking the profile plans with, 0 would never reach speed or stop
+const double LIMIT_MIN = 1.0;
+
+turn_profile::turn_profile() {}
+
+void turn_profile::pid_turn_set(okapi::QAngle p_target, int speed) {
+  pid_turn_set(p_target.convert(okapi::degree), speed);
+}
+
+void turn_profile::pid_turn_set(double itarget, int speed) {
+  target = itarget;
+  speed_input = abs(speed);
+  speed_max = MAX_RATE * ez::util::clamp(speed_input, 127, 0) / 127.0;
+  profile_rate = 0.0;
+
+  // There's no profile at 0 speed, EZ-Template gets the turn like any other
+  if (speed_max <= 0.0) {
+    running = false;
+    chassis.pid_turn_set(target, speed_input);
+    return;
+  }
+
+  // Give the turn one and a half times what the profile should take
+  double distance = fabs(ez::util::wrap_angle(target - chassis.drive_imu_get()));
+  double profile_time = distance / speed_max + speed_max / (2.0 * ACCEL) + speed_max / (2.0 * DECEL);
+  timeout = profile_time * 1500.0 + 300;
+  start_time = pros::millis();
+
+  // EZ-Template stays idle while this turn drives
+  chassis.drive_mode_set(ez::DISABLE, false);
+  running = true;
+}
+
+void turn_profile::iterate() {
+  if (!running) return;
+
+  // Something else took over the drive
+  if (chassis.drive_mode_get() != ez::DISABLE) {
+    running = false;
+    return;
+  }
+
+  double error = ez::util::wrap_angle(target - chassis.drive_imu_get());
+  double rate = gyro_rate_get();
+
+  // Settled, or ran out of time
+  if ((fabs(error) < TOLERANCE && fabs(rate) < SETTLE_RATE) || (int)pros::millis() - start_time > timeout) {
+    // EZ-Template has the turn before this stops, so motion events see one motion
+    chassis.pid_turn_set(target, speed_input);
+    running = false;
+    return;
+  }
+
+  // Fastest rate that can still stop in the remaining angle
+  double brake_rate = std::min(sqrt(2.0 * DECEL * fabs(error)), KP_ANGLE * fabs(error));
+
+  // Ramp up at the measured acceleration, restarting from 0 if the robot overshot
+  double last_rate = ez::util::sgn(profile_rate) == ez::util::sgn(error) ? fabs(profile_rate) : 0.0;
+  double ramp_rate = last_rate + ACCEL * (ez::util::DELAY_TIME / 1000.0);
+
+  profile_rate = std::min({speed_max, brake_rate, ramp_rate}) * ez::util::sgn(error);
+
+  // Feedforward from the max rate plus feedback on the gyro
+  double output = profile_rate * (127.0 / MAX_RATE) + KP_RATE * (profile_rate - rate);
+  output = ez::util::clamp(output, 127.0);
+  chassis.drive_set(output, -output);
+}
+
+void turn_profile::pid_wait() {
+  while (running)
+    pros::delay(ez::util::DELAY_TIME);
+}
+
+void turn_profile::stop() {
+  running = false;
+  chassis.drive_set(0, 0);
+}
+
+bool turn_profile::enabled() { return running; }
+
+void turn_profile::limits_set(double max_rate, double accel, double decel) {
+  MAX_RATE = fabs(max_rate);
+  ACCEL = std::max(fabs(accel), LIMIT_MIN);
+  DECEL = std::max(fabs(decel), LIMIT_MIN);
+}
+std::vector<double> turn_profile::limits_get() { return {MAX_RATE, ACCEL, DECEL}; }
+
+void turn_profile::constants_set(double kp_rate, double kp_angle) {
+  KP_RATE = kp_rate;
+  KP_ANGLE = kp_angle;
+}
+std::vector<double> turn_profile::constants_get() { return {KP_RATE, KP_ANGLE}; }
+
+void turn_profile::exit_condition_set(okapi::QAngle p_tolerance, double settle_rate) {
+  TOLERANCE = p_tolerance.convert(okapi::degree);
+  SETTLE_RATE = settle_rate;
+}
+
+void turn_profile::gyro_rate_reversed_set(bool reversed) { gyro_reversed = reversed; }
+
+double turn_profile::gyro_rate_get() {
+  double rate = chassis.imu.get_gyro_rate().z * chassis.drive_imu_scaler_get();
+  return gyro_reversed ? -rate : rate;
+}
+
+double turn_profile::profile_rate_get() { return profile_rate; }
+
+void turn_profile::limits_measure() {
+  stop();
+  chassis.drive_mode_set(ez::DISABLE);
+  pros::motor_brake_mode_e_t preference = chassis.drive_brake_get();
+  chassis.drive_brake_set(MOTOR_BRAKE_HOLD);
+
+  // Spin right at full power and record the rate every tick
+  const int SAMPLES = 150;
+  double rates[SAMPLES];
+  double start_angle = chassis.drive_imu_get();
+  chassis.drive_set(127, -127);
+  for (int i = 0; i < SAMPLES; i++) {
+    pros::delay(ez::util::DELAY_TIME);
+    rates[i] = chassis.imu.get_gyro_rate().z * chassis.drive_imu_scaler_get();
+  }
+
+  // The heading went up, so the gyro should have read positive
+  gyro_reversed = (chassis.drive_imu_get() - start_angle) * rates[SAMPLES - 1] < 0.0;
+  double sign = gyro_reversed ? -1.0 : 1.0;
+
+  double peak = 0.0;
+  for (int i = 0; i < SAMPLES; i++)
+    peak = std::max(peak, rates[i] * sign);
+
+  // Acceleration is how long it took to get to 90% of the peak
+  int rise = SAMPLES;
+  for (int i = 0; i < SAMPLES; i++) {
+    if (rates[i] * sign >= peak * 0.9) {
+      rise = i + 1;
+      break;
+    }
+  }
+  double accel = (peak * 0.9) / (rise * ez::util::DELAY_TIME / 1000.0);
+
+  // Brake and see how far it takes to stop
+  double brake_rate = gyro_rate_get();
+  double brake_angle = chassis.drive_imu_get();
+  chassis.drive_set(0, 0);
+  int brake_start = pros::millis();
+  while (fabs(gyro_rate_get()) > 5.0 && pros::millis() - brake_start < 1000)
+    pros::delay(ez::util::DELAY_TIME);
+  double stop_distance = std::max(fabs(chassis.drive_imu_get() - brake_angle), 1.0);
+  double decel = (brake_rate * brake_rate) / (2.0 * stop_distance);
+
+  limits_set(peak, accel, decel);
+  printf("Turn limits: fast_turn.limits_set(%.1f, %.1f, %.1f);%s\n", peak, accel, decel, gyro_reversed ? "  fast_turn.gyro_rate_reversed_set(true);" : "");
+
+  chassis.drive_brake_set(preference);
+}
+
+/**
+ * Runs the profiled turn every 10ms
+ */
+void turn_profile_task() {
+  while (true) {
+    if (!executive.enabled()) fast_turn.iterate();
+    pros::delay(ez::util::DELAY_TIME);
+  }
+}
+pros::Task turnProfileTask(turn_profile_task, "Turn Profile");
@@ -0,0 +1,207 @@
+/**
+ * The PROS, EZ-Template and chassis functions modules built on a computer call.
+ * See tools/host/main.h.
+ */
+#include <chrono>
+
+#include "main.h"
+
+host_drive chassis;
+host_executive executive;
+host_latency latency;
+
+host_motor intake, topintake;
+host_piston matchload, med, small;
+host_distance rightDS, backDS;
+host_events events;
+
+std::uint32_t host_time = 0;
+std::function<void()> host_tick = nullptr;
+
+// Inches per second at full power, the same as pursuit.velocity_max_set() in default_constants()
+const double MAX_SPEED = 65.0;
+
+// PROS
+extern "C" {
+std::uint32_t pros::c::millis() { return host_time; }
+void pros::c::delay(const std::uint32_t milliseconds) {
+  for (std::uint32_t left = milliseconds; left > 0;) {
+    std::uint32_t step = std::min(left, (std::uint32_t)ez::util::DELAY_TIME);
+    host_time += step;
+    left -= step;
+    chassis.drive_step(step / 1000.0);
+    if (host_tick) host_tick();
+  }
+}
+
+// The real clock, so the benchmark can time code
+std::uint64_t pros::c::micros() {
+  static auto start = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+}
+
+// Tasks never start, the programs call iterate() themselves
+pros::Task::Task(task_fn_t function, void* parameters, std::uint32_t prio, std::uint16_t stack_depth, const char* name) {}
+
+// EZ-Template's headers check for an SD card as they start
+std::int32_t pros::usd::is_installed() { return 0; }
+
+pros::Mutex::Mutex() {}
+bool pros::Mutex::take() { return true; }
+bool pros::Mutex::give() { return true; }
+
+// EZ-Template
+ez::Auton::Auton() {}
+ez::Auton::Auton(std::string name, std::function<void()> callback) : Name(name), auton_call(callback) {}
+
+double ez::util::to_rad(double input) { return input * M_PI / 180.0; }
+
+double ez::util::to_deg(double input) { return input * 180.0 / M_PI; }
+
+double ez::util::clamp(double input, double max, double min) { return std::min(std::max(input, min), max); }
+
+double ez::util::distance_to_point(ez::pose itarget, ez::pose icurrent) { return hypot(itarget.x - icurrent.x, itarget.y - icurrent.y); }
+
+double ez::util::absolute_angle_to_point(ez::pose itarget, ez::pose icurrent) {
+  if (itarget.x == icurrent.x && itarget.y == icurrent.y) return icurrent.theta;
+  return to_deg(atan2(itarget.x - icurrent.x, itarget.y - icurrent.y));
+}
+
+double ez::util::wrap_angle(double theta) {
+  while (theta > 180.0) theta -= 360.0;
+  while (theta < -180.0) theta += 360.0;
+  return theta;
+}
+
+double ez::util::turn_shortest(double target, double current, bool print) {
+  double output = current + wrap_angle(target - current);
+  if (print) printf("Turning to %.2f\n", output);
+  return output;
+}
+
+double ez::util::turn_longest(double target, double current, bool print) {
+  double error = wrap_angle(target - current);
+  double output = current + (error >= 0.0 ? error - 360.0 : error + 360.0);
+  if (print) printf("Turning to %.2f\n", output);
+  return output;
+}
+
+ez::pose ez::util::vector_off_point(double added, ez::pose icurrent) {
+  double angle = to_rad(icurrent.theta);
+  return {icurrent.x + added * sin(angle), icurrent.y + added * cos(angle), icurrent.theta};
+}
+
+ez::odom ez::util::united_odom_to_odom(ez::united_odom input) {
+  // ANGLE_NOT_SET doesn't survive the unit conversion
+  double theta = input.target.theta == ez::p_ANGLE_NOT_SET ? ez::ANGLE_NOT_SET : input.target.theta.convert(okapi::degree);
+  return {{input.target.x.convert(okapi::inch), input.target.y.convert(okapi::inch), theta},
+          input.drive_direction, input.max_xy_speed, input.turn_behavior};
+}
+
+std::vector<ez::odom> ez::util::united_odoms_to_odoms(std::vector<ez::united_odom> inputs) {
+  std::vector<ez::odom> output;
+  for (auto& input : inputs)
+    output.push_back(united_odom_to_odom(input));
+  return output;
+}
+
+// Chassis
+ez::pose host_drive::odom_pose_get() { return pose; }
+
+void host_drive::odom_xyt_set(okapi::QLength p_x, okapi::QLength p_y, okapi::QAngle p_theta) {
+  odom_xyt_set(p_x.convert(okapi::inch), p_y.convert(okapi::inch), p_theta.convert(okapi::degree));
+}
+
+void host_drive::odom_xyt_set(double x, double y, double theta) {
+  pose = {x, y, theta};
+  if (log) printf("  odom set    (%.1f, %.1f, %.1f)\n", x, y, theta);
+}
+
+double host_drive::odom_boomerang_distance_get() { return 12.0; }
+double host_drive::odom_boomerang_dlead_get() { return 0.5; }
+double host_drive::drive_width_get() { return 12.0; }
+
+void host_drive::drive_set(int left, int right) {
+  left_power = left;
+  right_power = right;
+}
+
+void host_drive::drive_step(double dt) {
+  if (left_power == 0 && right_power == 0) return;
+  double left = ez::util::clamp(left_power, 127, -127) / 127.0 * MAX_SPEED;
+  double right = ez::util::clamp(right_power, 127, -127) / 127.0 * MAX_SPEED;
+
+  // Along an arc, using the heading halfway through it
+  double turn = (left - right) / drive_width_get() * dt;
+  double heading = ez::util::to_rad(pose.theta) + turn / 2.0;
+  pose.x += (left + right) / 2.0 * dt * sin(heading);
+  pose.y += (left + right) / 2.0 * dt * cos(heading);
+  pose.theta += ez::util::to_deg(turn);
+}
+ez::e_mode host_drive::drive_mode_get() { return mode; }
+void host_drive::drive_mode_set(ez::e_mode p_mode, bool stop_drive) { mode = p_mode; }
+
+void host_drive::drive_along(double distance, const char* name) {
+  pose = ez::util::vector_off_point(distance, pose);
+  left_power = right_power = 0;
+  if (log) printf("  %-5s %6.1f  -> (%.1f, %.1f, %.1f)\n", name, distance, pose.x, pose.y, pose.theta);
+}
+
+void host_drive::pid_drive_set(okapi::QLength p_target, int speed, bool slew_on, bool toggle_heading) {
+  mode = ez::DRIVE;
+  drive_along(p_target.convert(okapi::inch), "drive");
+}
+
+void host_drive::pid_odom_set(double target, int speed, bool slew_on) {
+  mode = ez::PURE_PURSUIT;
+  drive_along(target, "odom");
+}
+
+void host_drive::pid_odom_set(okapi::QLength p_target, int speed, bool slew_on) { pid_odom_set(p_target.convert(okapi::inch), speed, slew_on); }
+
+void host_drive::pid_turn_set(okapi::QAngle p_target, int speed, bool slew_on) {
+  pose.theta = p_target.convert(okapi::degree);
+  mode = ez::TURN;
+  left_power = right_power = 0;
+  if (log) printf("  turn  %6.1f  -> (%.1f, %.1f, %.1f)\n", pose.theta, pose.x, pose.y, pose.theta);
+}
+
+void host_drive::pid_swing_set(ez::e_swing type, okapi::QAngle p_target, int speed, int opposite_speed, bool slew_on) {
+  // Turns about a point on the side that isn't swinging, further out the faster that side goes
+  double swing = std::max(abs(speed), 1), opposite = ez::util::clamp(opposite_speed, swing * 0.9, -swing);
+  double radius = drive_width_get() / 2.0 * (swing + opposite) / (swing - opposite);
+  double side = type == ez::RIGHT_SWING ? -1.0 : 1.0;  // The right side swings about a point on the left
+  ez::pose center = {pose.x + side * radius * cos(ez::util::to_rad(pose.theta)), pose.y - side * radius * sin(ez::util::to_rad(pose.theta))};
+
+  // The shortest way round, the same as default_constants() sets
+  pose.theta += ez::util::wrap_angle(p_target.convert(okapi::degree) - pose.theta);
+  pose.x = center.x - side * radius * cos(ez::util::to_rad(pose.theta));
+  pose.y = center.y + side * radius * sin(ez::util::to_rad(pose.theta));
+  mode = ez::SWING;
+  left_power = right_power = 0;
+  if (log) printf("  swing %6.1f  -> (%.1f, %.1f, %.1f)\n", pose.theta, pose.x, pose.y, pose.theta);
+}
+
+void host_drive::pid_odom_set(ez::odom imovement, bool slew_on) { pid_odom_set(std::vector<ez::odom>{imovement}, slew_on); }
+
+void host_drive::pid_odom_set(std::vector<ez::odom> imovements, bool slew_on) {
+  for (auto& m : imovements) {
+    // Face where it drove, or the angle it was asked to end at.  A follower can leave it on the point already
+    double heading = pose.theta;
+    if (ez::util::distance_to_point(m.target, pose) > 1.0)
+      heading = ez::util::absolute_angle_to_point(m.target, pose) + (m.drive_direction == ez::rev ? 180.0 : 0.0);
+    pose = {m.target.x, m.target.y, m.target.theta != ez::ANGLE_NOT_SET ? m.target.theta : heading};
+  }
+  mode = ez::PURE_PURSUIT;
+  left_power = right_power = 0;
+  if (log) printf("  odom  %zu pts  -> (%.1f, %.1f, %.1f)\n", imovements.size(), pose.x, pose.y, pose.theta);
+}
+
+void host_drive::pid_odom_set(ez::united_odom p_imovement, bool slew_on) { pid_odom_set(ez::util::united_odom_to_odom(p_imovement), slew_on); }
+
+void host_drive::pid_odom_set(std::vector<ez::united_odom> p_imovements, bool slew_on) {
+  pid_odom_set(ez::util::united_odoms_to_odoms(p_imovements), slew_on);
+}
+
+void host_drive::pid_wait() { mode = ez::DISABLE; }
@@ -0,0 +1,124 @@
+#pragma once
+
+/**
+ * Stands in for include/main.h when modules are built on a computer by the
+ * programs in tools/.
+ *
+ * Quoted includes look next to the file first and then down the -I list, so
+ * putting -Itools/host before -Iinclude makes every src/ file that includes
+ * "main.h" get this one instead.  The PROS and EZ-Template headers are the
+ * real ones, only the functions these modules call are filled in, by
+ * tools/host/host.cpp.  EZ-Template's math is in its prebuilt library, so the
+ * few util functions used here are written out again to do the same job.
+ *
+ * EZ-Template motions put the robot where they would have ended up.
+ * drive_set() drives it, moving it on the made up clock each time
+ * pros::delay() passes a tick, so followers like pursuit can drive it when
+ * host_tick calls their iterate().  The chassis doesn't drive, each motion puts the
+ * robot where it would have ended up and logs it.
+ */
+#include "EZ-Template/api.hpp"
+#include "api.h"
+
+// Modules that build on a computer
+#include "benchmark.hpp"
+#include "path.hpp"
+#include "pursuit.hpp"
+#include "route.hpp"
+
+/**
+ * Just enough of ez::Drive for the modules above.
+ */
+class host_drive {
+ public:
+  ez::pose odom_pose_get();
+  void odom_xyt_set(okapi::QLength p_x, okapi::QLength p_y, okapi::QAngle p_theta);
+  void odom_xyt_set(double x, double y, double theta);
+  double odom_boomerang_distance_get();
+  double odom_boomerang_dlead_get();
+  double drive_width_get();
+
+  void drive_set(int left, int right);
+  ez::e_mode drive_mode_get();
+  void drive_mode_set(ez::e_mode p_mode, bool stop_drive = true);
+
+  void pid_drive_set(okapi::QLength p_target, int speed, bool slew_on = false, bool toggle_heading = true);
+  void pid_turn_set(okapi::QAngle p_target, int speed, bool slew_on = false);
+  void pid_swing_set(ez::e_swing type, okapi::QAngle p_target, int speed, int opposite_speed = 0, bool slew_on = false);
+  void pid_odom_set(double target, int speed, bool slew_on = false);
+  void pid_odom_set(okapi::QLength p_target, int speed, bool slew_on = false);
+  void pid_odom_set(ez::odom imovement, bool slew_on = false);
+  void pid_odom_set(std::vector<ez::odom> imovements, bool slew_on = false);
+  void pid_odom_set(ez::united_odom p_imovement, bool slew_on = false);
+  void pid_odom_set(std::vector<ez::united_odom> p_imovements, bool slew_on = false);
+  void pid_wait();
+
+  /**
+   * Moves the robot by the last drive_set() for this many seconds.
+   */
+  void drive_step(double dt);
+
+  /**
+   * Prints every motion when true.
+   */
+  bool log = false;
+
+ private:
+  ez::pose pose = {0.0, 0.0, 0.0};
+  ez::e_mode mode = ez::DISABLE;
+  int left_power = 0;
+  int right_power = 0;
+
+  void drive_along(double distance, const char* name);
+};
+
+/**
+ * The parts of the cyclic executive and latency compensation pursuit.cpp uses.
+ */
+struct host_executive {
+  bool enabled() { return false; }
+};
+struct host_latency {
+  ez::pose pose_predict(ez::pose current) { return current; }
+};
+
+/**
+ * Stand-ins for the parts of include/subsystems.hpp and motion events that
+ * src/skills.cpp uses.  Motors and pistons do nothing, and distance sensors
+ * read whatever the program sets.  Events only move them, so they're never run.
+ */
+struct host_motor {
+  void move(int voltage) {}
+};
+struct host_piston {
+  bool state = false;
+  void set(bool input) { state = input; }
+  bool get() { return state; }
+};
+struct host_distance {
+  int reading = 0;
+  int get() { return reading; }
+};
+struct host_events {
+  bool at_index(int index, std::function<void()> callback) { return true; }
+};
+
+extern host_motor intake, topintake;
+extern host_piston matchload, med, small;
+extern host_distance rightDS, backDS;
+extern host_events events;
+
+extern host_drive chassis;
+extern host_executive executive;
+extern host_latency latency;
+
+/**
+ * Milliseconds since the program started on the made up clock pros::millis() and pros::delay() use.
+ */
+extern std::uint32_t host_time;
+
+/**
+ * Runs every tick of the made up clock, the way tasks run on the robot.  Set it
+ * to call iterate() on whatever the program needs running.
+ */
+extern std::function<void()> host_tick;
@@ -0,0 +1,124 @@
+/**
+ * Times a pure pursuit tick on paths from 10 to 10,000 points.
+ *
+ * Build and run it on your computer, not the robot:
+ *   g++ -std=gnu++20 -O2 -Itools/host -Iinclude tools/pursuit_benchmark.cpp src/pursuit.cpp src/path.cpp tools/host/host.cpp -o pursuit_benchmark
+ *   ./pursuit_benchmark
+ *
+ * The robot is moved along a wavy path a little each tick and pushed sideways
+ * now and then, and pure_pursuit::iterate() is timed.  Next to it is the same
+ * tick searching the whole path for the closest and look ahead points, the way
+ * it was done before the search window.  The window should cost the same at
+ * every length, and the whole path search should grow with it.
+ */
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "main.h"
+
+// Inches the robot moves each tick, about 60 in/s
+const double STEP = 0.6;
+
+// Every this many ticks the robot is pushed off the path
+const int PUSH_TICKS = 150;
+const double PUSH = 18.0;
+
+const double SPACING = 0.5;
+const double LOOK_AHEAD = 10.0;
+
+/**
+ * A wavy path with about this many points at the normal spacing.
+ */
+static std::vector<ez::odom> wavy_path(int points) {
+  std::vector<ez::odom> output;
+  double length = 0.0;
+  ez::pose last = {0.0, 0.0};
+  for (int k = 1; length < points * SPACING; k++) {
+    ez::pose next = {8.0 * sin(k / 3.0), 4.0 * k};
+    length += ez::util::distance_to_point(next, last);
+    output.push_back({next, ez::fwd, 110});
+    last = next;
+  }
+  return output;
+}
+
+/**
+ * The look ahead point found by checking every point on the path.
+ */
+static int full_search(const path_buffer& path, ez::pose current) {
+  int closest = 0;
+  double best = path.distance_to(0, current);
+  for (int i = 1; i < path.size(); i++) {
+    double d = path.distance_to(i, current);
+    if (d < best) {
+      best = d;
+      closest = i;
+    }
+  }
+  for (int i = closest; i < path.size(); i++)
+    if (path.distance_to(i, current) >= LOOK_AHEAD) return i;
+  return path.size() - 1;
+}
+
+/**
+ * Drives the path, the pose each tick is handed to time().  Returns the ticks driven, time() returns false to stop early.
+ */
+template <class F>
+static int drive(const path_buffer& path, F time) {
+  int ticks = 0;
+  double along = 0.0;
+  int index = 0;
+  while (index < path.size() - 1) {
+    ez::pose current = path.odom_get(index).target;
+    if (ticks % PUSH_TICKS == PUSH_TICKS - 1) current.x += PUSH;
+    chassis.odom_xyt_set(current.x, current.y, 0.0);
+    ticks++;
+    if (!time(current)) break;
+
+    along += STEP;
+    while (index < path.size() - 1 && along >= path.distance_between(index, index + 1)) {
+      along -= path.distance_between(index, index + 1);
+      index++;
+    }
+    pros::delay(ez::util::DELAY_TIME);
+  }
+  return ticks;
+}
+
+int main() {
+  printf("%8s %8s %14s %16s\n", "points", "ticks", "window ns/tick", "full path ns/tick");
+
+  for (int points : {10, 30, 100, 300, 1000, 3000, 10000}) {
+    pure_pursuit follower(points + 64);
+    follower.spacing_set(SPACING * okapi::inch);
+    follower.look_ahead_set(LOOK_AHEAD * okapi::inch);
+    follower.smooth_constants_set(0.0, 0.0);
+
+    chassis.odom_xyt_set(0.0, 0.0, 0.0);
+    chassis.drive_mode_set(ez::DISABLE);
+    follower.pid_pursuit_set(wavy_path(points));
+    const path_buffer& path = follower.path_buffer_get();
+
+    // The follower keeps its own index, so it gets the ticks in order
+    double window_ns = 0.0;
+    int ticks = drive(path, [&](ez::pose current) {
+      auto start = std::chrono::steady_clock::now();
+      follower.iterate();
+      window_ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+      return follower.enabled();
+    });
+
+    volatile int sink = 0;
+    double full_ns = 0.0;
+    int full_ticks = drive(path, [&](ez::pose current) {
+      auto start = std::chrono::steady_clock::now();
+      sink = full_search(path, current);
+      full_ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+      return true;
+    });
+
+    printf("%8i %8i %14.0f %16.0f\n", path.size(), ticks, window_ns / std::max(ticks, 1), full_ns / std::max(full_ticks, 1));
+  }
+  return 0;
+}
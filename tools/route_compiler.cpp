@@ -0,0 +1,214 @@
+/**
+ * Compiles a text route into the file sd_route runs, and checks it on the way.
+ *
+ * Build and run it on your computer, not the robot:
+ *   g++ -std=c++17 -Iinclude tools/route_compiler.cpp -o route_compiler
+ *   ./route_compiler tools/example.route route.bin
+ * then copy route.bin to the root of the SD card.
+ *
+ * A route has one instruction per line, an opcode from route_format::OPS and
+ * its arguments, and # starts a comment.  Distances are inches, angles are
+ * degrees, times are ms.  Anything that wouldn't run on the robot is an error
+ * with its line number, and nothing is written.
+ */
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "route_format.hpp"
+
+using namespace route_format;
+
+static std::vector<std::uint8_t> payload;
+static int errors = 0;
+
+static void error(int line, const std::string& message) {
+  fprintf(stderr, "line %i: %s\n", line, message.c_str());
+  errors++;
+}
+
+static void write16(int value) {
+  payload.push_back(value & 0xFF);
+  payload.push_back((value >> 8) & 0xFF);
+}
+
+static int find(const char* const* names, int count, const std::string& word) {
+  for (int i = 0; i < count; i++)
+    if (word == names[i]) return i;
+  return -1;
+}
+
+// Words a flag can be, on top of 0 and 1
+static int flag(const std::string& word) {
+  if (word == "0" || word == "off" || word == "false" || word == "fwd" || word == "left" || word == "noslew") return 0;
+  if (word == "1" || word == "on" || word == "true" || word == "rev" || word == "right" || word == "slew") return 1;
+  return -1;
+}
+
+static bool number(const std::string& word, double* value) {
+  char* end = nullptr;
+  *value = strtod(word.c_str(), &end);
+  return end != word.c_str() && *end == '\0' && std::isfinite(*value);
+}
+
+/**
+ * Encodes one argument.  Returns false if it's out of range or isn't the right kind.
+ */
+static bool encode(std::uint8_t op, int index, char type, const std::string& word, int line) {
+  double value = 0.0;
+  if (type == 'f') {
+    int found = -1;
+    if (index == 0 && op == MOTOR)
+      found = find(MOTORS, MOTOR_COUNT, word);
+    else if (index == 0 && op == PISTON)
+      found = find(PISTONS, PISTON_COUNT, word);
+    else
+      found = flag(word);
+    if (found < 0) {
+      error(line, "'" + word + "' isn't a " + (index == 0 && op == MOTOR ? "motor" : index == 0 && op == PISTON ? "piston" : "flag"));
+      return false;
+    }
+    payload.push_back(found);
+    return true;
+  }
+
+  if (type == 'a' && word == "-") {
+    if (!angle_optional(op)) {
+      error(line, std::string(OPS[op].name) + " needs an angle, only point and path_point can leave it out with '-'");
+      return false;
+    }
+    write16((std::uint16_t)NO_ANGLE);
+    return true;
+  }
+  if (!number(word, &value)) {
+    error(line, "'" + word + "' isn't a number");
+    return false;
+  }
+
+  if (type == 's') {
+    // Motors can spin backwards, motions only take a speed
+    int low = op == MOTOR ? -127 : 0;
+    if (value != std::round(value) || value < low || value > 127) {
+      error(line, "speed " + word + " isn't a whole number from " + std::to_string(low) + " to 127");
+      return false;
+    }
+    payload.push_back((std::uint8_t)(std::int8_t)value);
+  } else if (type == 't') {
+    if (value != std::round(value) || value < 0 || value > 65535) {
+      error(line, "time " + word + " isn't a whole number of ms from 0 to 65535");
+      return false;
+    }
+    write16(value);
+  } else {
+    double scaled = std::round(value * (type == 'a' ? ANGLE_SCALE : DISTANCE_SCALE));
+    if (scaled <= NO_ANGLE || scaled > INT16_MAX) {
+      error(line, std::string(type == 'a' ? "angle " : "distance ") + word + " is too big");
+      return false;
+    }
+    write16((std::int16_t)scaled);
+  }
+  return true;
+}
+
+int main(int argc, char** argv) {
+  if (argc != 3) {
+    fprintf(stderr, "usage: %s route.txt route.bin\n", argv[0]);
+    return 2;
+  }
+  std::ifstream input(argv[1]);
+  if (!input) {
+    fprintf(stderr, "can't read %s\n", argv[1]);
+    return 2;
+  }
+
+  std::string text;
+  int line = 0, instructions = 0, points = 0, points_line = 0;
+  bool moved = false;
+  while (std::getline(input, text)) {
+    line++;
+    text = text.substr(0, text.find('#'));
+    std::istringstream words(text);
+    std::string name, word;
+    if (!(words >> name)) continue;
+
+    int op = -1;
+    for (int i = 0; i < OP_COUNT && op < 0; i++)
+      if (name == OPS[i].name) op = i;
+    if (op < 0 || op == END) {
+      error(line, "'" + name + "' isn't an instruction");
+      continue;
+    }
+
+    std::vector<std::string> args;
+    while (words >> word)
+      args.push_back(word);
+
+    // Flags on the end can be left off, they're 0
+    const char* types = OPS[op].args;
+    int wanted = strlen(types), required = wanted;
+    while (required > 0 && types[required - 1] == 'f' && op != MOTOR && op != PISTON)
+      required--;
+    if ((int)args.size() < required || (int)args.size() > wanted) {
+      error(line, name + " takes " + (required == wanted ? "" : std::to_string(required) + " to ") + std::to_string(wanted) + " arguments, not " + std::to_string(args.size()));
+      continue;
+    }
+
+    int start = payload.size();
+    payload.push_back(op);
+    bool ok = true;
+    for (int i = 0; i < wanted && ok; i++)
+      ok = i < (int)args.size() ? encode(op, i, types[i], args[i], line) : encode(op, i, types[i], "0", line);
+    if (!ok) {
+      payload.resize(start);
+      continue;
+    }
+    instructions++;
+
+    // Things that would compile but not run the way they read
+    if (op == PATH_POINT) {
+      if (points == 0) points_line = line;
+      if (++points > MAX_PATH) error(line, "paths can't have more than " + std::to_string(MAX_PATH) + " points");
+    } else if (points > 0 && op != PATH_RUN) {
+      error(line, "the path started on line " + std::to_string(points_line) + " needs path_run before " + name);
+    }
+    if (op == PATH_RUN) {
+      if (points == 0) error(line, "path_run without any path_point before it");
+      points = 0;
+    }
+    if (op == DRIVE || op == ODOM_DRIVE || op == TURN || op == SWING || op == POINT || op == PATH_RUN) moved = true;
+    if ((op == WAIT || op == WAIT_QUICK || op == WAIT_CHAIN || op == WAIT_UNTIL) && !moved)
+      error(line, name + " before any motion");
+  }
+  if (points > 0) error(points_line, "the path started here never has path_run");
+
+  payload.push_back(END);
+  instructions++;
+  if (HEADER_SIZE + (int)payload.size() > MAX_BYTES)
+    error(line, "route is " + std::to_string(HEADER_SIZE + payload.size()) + " bytes, the robot holds " + std::to_string(MAX_BYTES));
+
+  if (errors > 0) {
+    fprintf(stderr, "%i errors, %s wasn't written\n", errors, argv[2]);
+    return 1;
+  }
+
+  std::uint8_t header[HEADER_SIZE] = {0};
+  std::uint32_t size = payload.size(), sum = checksum(payload.data(), size);
+  memcpy(header, MAGIC, 4);
+  header[4] = VERSION;
+  for (int i = 0; i < 2; i++) header[6 + i] = (instructions >> (8 * i)) & 0xFF;
+  for (int i = 0; i < 4; i++) header[8 + i] = (size >> (8 * i)) & 0xFF;
+  for (int i = 0; i < 4; i++) header[12 + i] = (sum >> (8 * i)) & 0xFF;
+
+  FILE* output = fopen(argv[2], "wb");
+  if (output == nullptr || fwrite(header, 1, HEADER_SIZE, output) != HEADER_SIZE || fwrite(payload.data(), 1, size, output) != size) {
+    fprintf(stderr, "can't write %s\n", argv[2]);
+    return 2;
+  }
+  fclose(output);
+  printf("%i instructions, %i bytes written to %s\n", instructions, HEADER_SIZE + (int)size, argv[2]);
+  return 0;
+}
@@ -0,0 +1,101 @@
+/**
+ * Runs the skills route on your computer and checks that its segments chain.
+ *
+ * Build and run it on your computer, not the robot:
+ *   g++ -std=gnu++20 -O2 -Itools/host -Iinclude tools/route_segments.cpp src/skills.cpp src/route.cpp src/pursuit.cpp src/path.cpp tools/host/host.cpp -o route_segments
+ *   ./route_segments
+ *
+ * src/skills.cpp is built as is against tools/host.  EZ-Template motions put
+ * the robot where they would have ended up, and pursuit drives it.  The whole
+ * route is run once and every segment's start pose is checked against where
+ * the segments before it left the robot.  That start pose is where the
+ * selector sets odom when skills is run from that segment, so one that's off
+ * means running from there starts somewhere the full run never is.  Then
+ * run_from() and run_segment() are run for each segment.
+ *
+ * It exits with 1 if a start pose doesn't match.
+ */
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#include "main.h"
+
+extern route fullSkillsRoute;
+
+// How far a start pose can be from where the route leaves the robot, in inches and degrees
+const double POSE_TOLERANCE = 1.0;
+const double ANGLE_TOLERANCE = 2.0;
+
+// Longest a segment can take before it's stuck, in ms
+const std::uint32_t SEGMENT_TIMEOUT = 60000;
+
+std::uint32_t segment_start = 0;
+
+/**
+ * Prints a pose and how far it is from the segment's start pose.  Returns false if it's too far.
+ */
+static bool check(int index, ez::pose current) {
+  if (!fullSkillsRoute.start_known(index)) {
+    printf("  %-12s sets odom itself\n", fullSkillsRoute.name_get(index).c_str());
+    return true;
+  }
+  ez::united_pose start = fullSkillsRoute.start_get(index);
+  double x = start.x.convert(okapi::inch), y = start.y.convert(okapi::inch), theta = start.theta.convert(okapi::degree);
+  double off = hypot(current.x - x, current.y - y);
+  double turned = fabs(remainder(current.theta - theta, 360.0));
+  bool ok = off <= POSE_TOLERANCE && turned <= ANGLE_TOLERANCE;
+  printf("  %-12s starts at (%.1f, %.1f, %.1f), robot is at (%.1f, %.1f, %.1f)%s\n", fullSkillsRoute.name_get(index).c_str(), x, y, theta,
+         current.x, current.y, current.theta, ok ? "" : "  <- doesn't match");
+  return ok;
+}
+
+int main() {
+  // The same as default_constants()
+  pursuit.look_ahead_set(5_in, 14_in);
+  pursuit.velocity_max_set(65);
+  pursuit.curve_speed_constant_set(5);
+  pursuit.curve_decel_set(4);
+  pursuit.smooth_constants_set(0.75, 0.03);
+  pursuit.window_set(40);
+  pursuit.rejoin_distance_set(6_in);
+  pursuit.chain_radius_set(4_in);
+
+  // The segments that read these set odom from them, so they don't change whether the route chains
+  rightDS.reading = 1440;
+  backDS.reading = 552;
+
+  host_tick = [] {
+    pursuit.iterate();
+    if (host_time - segment_start > SEGMENT_TIMEOUT) {
+      printf("  stuck, pursuit never reached the end of its path\n");
+      exit(1);
+    }
+  };
+
+  int failed = 0;
+  printf("Whole route\n");
+  fullSkillsRoute.segment_callback_set([&](int i) {
+    segment_start = host_time;
+    if (i > 0 && !check(i, chassis.odom_pose_get())) failed++;
+  });
+  fullSkillsRoute.run();
+
+  // Only the motions are wanted from here on
+  fullSkillsRoute.segment_callback_set([](int i) {
+    segment_start = host_time;
+    printf("  -- %s\n", fullSkillsRoute.name_get(i).c_str());
+  });
+  chassis.log = true;
+  for (int i = 0; i < fullSkillsRoute.size(); i++) {
+    printf("\nrun_from(%i)\n", i);
+    fullSkillsRoute.run_from(i);
+  }
+  for (int i = 0; i < fullSkillsRoute.size(); i++) {
+    printf("\nrun_segment(%i)\n", i);
+    fullSkillsRoute.run_segment(i);
+  }
+
+  if (failed > 0) printf("\n%i segments don't start where the route leaves the robot\n", failed);
+  return failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,95 @@
+/**
+ * Compares path_buffer::smooth() with the gradient descent smoothing EZ-Template uses.
+ *
+ * Build and run it on your computer, not the robot:
+ *   g++ -std=gnu++20 -O2 -Itools/host -Iinclude tools/smooth_benchmark.cpp src/path.cpp tools/host/host.cpp -o smooth_benchmark
+ *   ./smooth_benchmark
+ *
+ * Every path is smoothed both ways with the constants autons.cpp uses.  The
+ * gradient descent here is Drive::smooth_path() written out, it runs until the
+ * points move less than the tolerance, so how many passes it takes depends on
+ * the path.  The table shows how long each took and how far apart their points
+ * ended up.
+ */
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "main.h"
+
+const double WEIGHT_SMOOTH = 0.75;
+const double WEIGHT_DATA = 0.03;
+const double TOLERANCE = 0.0001;
+const double SPACING = 0.5;
+
+/**
+ * Drive::smooth_path(), returns how many passes it took.
+ */
+static int gradient_descent(std::vector<ez::odom>& path) {
+  std::vector<ez::odom> start = path;
+  int passes = 0;
+  double change = TOLERANCE;
+  while (change >= TOLERANCE) {
+    change = 0.0;
+    passes++;
+    for (size_t i = 1; i + 1 < path.size(); i++) {
+      // Points where the direction changes stay put
+      if (path[i].drive_direction != path[i + 1].drive_direction) continue;
+      double* point[2] = {&path[i].target.x, &path[i].target.y};
+      double before[2] = {start[i].target.x, start[i].target.y};
+      double previous[2] = {path[i - 1].target.x, path[i - 1].target.y};
+      double next[2] = {path[i + 1].target.x, path[i + 1].target.y};
+      for (int j = 0; j < 2; j++) {
+        double old = *point[j];
+        *point[j] += WEIGHT_DATA * (before[j] - *point[j]) + WEIGHT_SMOOTH * (previous[j] + next[j] - 2.0 * *point[j]);
+        change += fabs(old - *point[j]);
+      }
+    }
+  }
+  return passes;
+}
+
+/**
+ * Points every SPACING inches along straight lines between corners.
+ */
+static std::vector<ez::odom> inject(const std::vector<ez::pose>& corners) {
+  std::vector<ez::odom> output = {{corners[0], ez::fwd, 110}};
+  for (size_t c = 1; c < corners.size(); c++) {
+    ez::pose a = corners[c - 1], b = corners[c];
+    int n = std::max(1, (int)ceil(ez::util::distance_to_point(a, b) / SPACING));
+    for (int k = 1; k <= n; k++)
+      output.push_back({{a.x + (b.x - a.x) * k / n, a.y + (b.y - a.y) * k / n}, ez::fwd, 110});
+  }
+  return output;
+}
+
+static void compare(const char* name, std::vector<ez::odom> points) {
+  path_buffer path(points.size());
+  for (auto& p : points)
+    path.push_back(p);
+
+  auto start = std::chrono::steady_clock::now();
+  path.smooth(WEIGHT_SMOOTH, WEIGHT_DATA);
+  double solve_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+  start = std::chrono::steady_clock::now();
+  int passes = gradient_descent(points);
+  double descent_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+  double apart = 0.0;
+  for (int i = 0; i < path.size(); i++)
+    apart = std::max(apart, hypot(points[i].target.x - path.x[i], points[i].target.y - path.y[i]));
+
+  printf("%-12s %7i %12.1f %14.1f %8i %10.4f\n", name, path.size(), solve_us, descent_us, passes, apart);
+}
+
+int main() {
+  printf("%-12s %7s %12s %14s %8s %10s\n", "path", "points", "smooth() us", "descent us", "passes", "apart in");
+
+  compare("L", inject({{0, 0}, {0, 50}, {50, 50}}));
+  compare("zigzag", inject({{0, 0}, {24, 24}, {0, 48}, {24, 72}, {0, 96}}));
+  compare("square", inject({{0, 0}, {0, 48}, {48, 48}, {48, 0}, {0, 0}}));
+  compare("straight", inject({{0, 0}, {0, 130}}));
+  compare("long", inject({{-60, -60}, {-60, 60}, {0, 0}, {60, 60}, {60, -60}, {-60, -60}, {0, 60}, {60, 0}}));
+  return 0;
+}
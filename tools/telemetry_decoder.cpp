@@ -0,0 +1,290 @@
+/**
+ * Reads the robot's binary telemetry and writes each channel to a CSV file as it arrives.
+ *
+ * Build and run it on your computer, not the robot:
+ *   g++ -std=c++17 -Iinclude tools/telemetry_decoder.cpp -o telemetry_decoder
+ *   ./telemetry_decoder /dev/ttyACM1 logs
+ * The port can also be a file saved from it earlier, or - for stdin.  Every
+ * channel goes to logs/<channel>.csv, and the newest values are shown in the
+ * terminal once a second.
+ *
+ *   ./telemetry_decoder --loopback logs
+ * makes up a stream the way the robot does, with printf text mixed in and
+ * bytes flipped, and checks every frame that wasn't damaged comes out the other
+ * side and every one that was is thrown away.
+ */
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "telemetry_format.hpp"
+
+using namespace telemetry_format;
+
+struct channel_t {
+  std::string name;
+  std::vector<std::string> values;
+  FILE* csv = nullptr;
+  std::vector<float> newest;
+  std::uint32_t time = 0;
+  int frames = 0;
+};
+
+static std::map<int, channel_t> channels;
+static std::string directory = ".";
+static int good = 0, bad = 0, undescribed = 0;
+
+static std::string file_name(const std::string& name) {
+  std::string output;
+  for (char c : name)
+    output += isalnum(c) ? c : '_';
+  return directory + "/" + output + ".csv";
+}
+
+static void describe(const std::uint8_t* frame, int size) {
+  int id = frame[1], count = frame[2];
+  const char* name = (const char*)&frame[3];
+  int name_size = strnlen(name, size - 3);
+  if (3 + name_size + 1 >= size) return;
+  const char* values = name + name_size + 1;
+  if (strnlen(values, size - 4 - name_size) >= (size_t)(size - 4 - name_size)) return;
+
+  channel_t& channel = channels[id];
+  if (channel.csv != nullptr && channel.name == name) return;
+  if (channel.csv != nullptr) fclose(channel.csv);
+  channel.name = name;
+  channel.values.clear();
+  std::string value;
+  for (const char* c = values;; c++) {
+    if (*c == ',' || *c == '\0') {
+      channel.values.push_back(value);
+      value.clear();
+      if (*c == '\0') break;
+    } else {
+      value += *c;
+    }
+  }
+  channel.values.resize(count);
+  channel.csv = fopen(file_name(channel.name).c_str(), "w");
+  if (channel.csv == nullptr) return;
+  fprintf(channel.csv, "ms");
+  for (auto& v : channel.values)
+    fprintf(channel.csv, ",%s", v.c_str());
+  fprintf(channel.csv, "\n");
+}
+
+static void data(const std::uint8_t* frame, int size) {
+  int id = frame[1], count = frame[6];
+  if (size != 7 + count * 4 || count > MAX_VALUES) {
+    bad++;
+    return;
+  }
+  auto found = channels.find(id);
+  if (found == channels.end() || found->second.csv == nullptr) {
+    // The channel is described every couple of seconds, so this only happens right after starting
+    undescribed++;
+    return;
+  }
+  channel_t& channel = found->second;
+  memcpy(&channel.time, &frame[2], 4);
+  channel.newest.resize(count);
+  memcpy(channel.newest.data(), &frame[7], count * 4);
+  channel.frames++;
+  fprintf(channel.csv, "%u", channel.time);
+  for (float v : channel.newest)
+    fprintf(channel.csv, ",%g", v);
+  fprintf(channel.csv, "\n");
+  fflush(channel.csv);
+}
+
+/**
+ * Handles everything between two zeros.  Returns true if it was a good frame.
+ */
+static bool frame(const std::uint8_t* encoded, int size) {
+  if (size == 0) return false;
+  std::uint8_t decoded[MAX_FRAME];
+  int length = cobs_decode(encoded, size, decoded, MAX_FRAME);
+  if (length < 3 || crc8(decoded, length - 1) != decoded[length - 1]) {
+    bad++;
+    return false;
+  }
+  length--;
+  if (decoded[0] == DESCRIBE && length >= 5)
+    describe(decoded, length);
+  else if (decoded[0] == DATA && length >= 7)
+    data(decoded, length);
+  else {
+    bad++;
+    return false;
+  }
+  good++;
+  return true;
+}
+
+/**
+ * Splits bytes into frames on zeros.
+ */
+struct splitter {
+  std::vector<std::uint8_t> pending;
+  int frames = 0;
+
+  void feed(const std::uint8_t* bytes, int size) {
+    for (int i = 0; i < size; i++) {
+      if (bytes[i] != 0) {
+        // Nothing real is this long, so it's text or noise
+        if (pending.size() < (size_t)MAX_ENCODED * 4) pending.push_back(bytes[i]);
+        continue;
+      }
+      if (!pending.empty() && pending.size() <= (size_t)MAX_ENCODED && frame(pending.data(), pending.size())) frames++;
+      else if (!pending.empty() && pending.size() > (size_t)MAX_ENCODED) bad++;
+      pending.clear();
+    }
+  }
+};
+
+static void show() {
+  printf("\033[H\033[J%i frames, %i bad, %i before their channel was described\n\n", good, bad, undescribed);
+  for (auto& [id, channel] : channels) {
+    printf("%-14s %8u ms ", channel.name.c_str(), channel.time);
+    for (size_t i = 0; i < channel.newest.size() && i < channel.values.size(); i++)
+      printf(" %s %.2f", channel.values[i].c_str(), channel.newest[i]);
+    printf("\n");
+  }
+  fflush(stdout);
+}
+
+static int open_port(const char* path) {
+  if (std::string(path) == "-") return STDIN_FILENO;
+  int fd = open(path, O_RDONLY | O_NOCTTY);
+  if (fd < 0) return -1;
+
+  // A serial port has to be raw, or the terminal driver eats bytes
+  termios settings;
+  if (tcgetattr(fd, &settings) == 0) {
+    cfmakeraw(&settings);
+    cfsetspeed(&settings, B115200);
+    tcsetattr(fd, TCSANOW, &settings);
+  }
+  return fd;
+}
+
+/**
+ * Appends one frame the way telemetry_stream::queue() does, a zero then the COBS frame and its zero.
+ */
+static void encode(std::vector<std::uint8_t>& stream, std::vector<std::uint8_t> frame) {
+  frame.push_back(crc8(frame.data(), frame.size()));
+  std::uint8_t encoded[MAX_ENCODED];
+  int size = cobs_encode(frame.data(), frame.size(), encoded);
+  stream.push_back(0);
+  stream.insert(stream.end(), encoded, encoded + size);
+}
+
+static std::vector<std::uint8_t> describe_frame(int id, const char* name, const char* values, int count) {
+  std::vector<std::uint8_t> frame = {DESCRIBE, (std::uint8_t)id, (std::uint8_t)count};
+  frame.insert(frame.end(), name, name + strlen(name) + 1);
+  frame.insert(frame.end(), values, values + strlen(values) + 1);
+  return frame;
+}
+
+static std::vector<std::uint8_t> data_frame(int id, std::uint32_t ms, std::vector<float> values) {
+  std::vector<std::uint8_t> frame = {DATA, (std::uint8_t)id, 0, 0, 0, 0, (std::uint8_t)values.size()};
+  memcpy(&frame[2], &ms, 4);
+  std::uint8_t* bytes = (std::uint8_t*)values.data();
+  frame.insert(frame.end(), bytes, bytes + values.size() * 4);
+  return frame;
+}
+
+static int loopback() {
+  std::mt19937 random(1);
+  std::uniform_real_distribution<double> chance(0.0, 1.0);
+  splitter input;
+  int sent = 0, damaged = 0;
+
+  for (std::uint32_t ms = 0; ms < 60000; ms += 10) {
+    std::vector<std::uint8_t> stream;
+    if (ms % 2000 == 0) {
+      encode(stream, describe_frame(0, "pose", "x,y,theta", 3));
+      encode(stream, describe_frame(1, "drive pid", "error,output", 2));
+      sent += 2;
+    }
+    if (ms % 20 == 0) {
+      double t = ms / 1000.0;
+      encode(stream, data_frame(0, ms, {(float)(24 * sin(t)), (float)(24 * cos(t)), (float)fmod(t * 57.3, 360)}));
+      sent++;
+    }
+    if (ms % 50 == 0) {
+      // Zeros and 0xFF runs are what COBS gets wrong if it's going to
+      encode(stream, data_frame(1, ms, {0.0f, ms % 1000 == 0 ? NAN : (float)(ms % 127)}));
+      sent++;
+    }
+
+    // Text from printf lands between frames
+    if (chance(random) < 0.05) {
+      const char* text = "Blocked, recovery attempt 1\n";
+      stream.insert(stream.end(), text, text + strlen(text));
+    }
+
+    // Flip a byte inside a frame now and then, that frame has to be thrown away and the next one still read
+    bool flipped = false;
+    if (chance(random) < 0.02 && stream.size() > 4) {
+      int at = 1 + random() % (stream.size() - 2);
+      if (stream[at] != 0) {
+        stream[at] ^= 1 << (random() % 8);
+        flipped = true;
+      }
+    }
+    damaged += flipped;
+    input.feed(stream.data(), stream.size());
+  }
+  std::uint8_t zero = 0;
+  input.feed(&zero, 1);
+
+  printf("%i frames sent, %i damaged, %i decoded, %i rejected\n", sent, damaged, input.frames, bad);
+  for (auto& [id, channel] : channels)
+    printf("  %-10s %i frames to %s\n", channel.name.c_str(), channel.frames, file_name(channel.name).c_str());
+
+  // A flipped byte costs the frame it's in and, if it was a zero, the one after it
+  bool passed = input.frames >= sent - 2 * damaged && input.frames <= sent && channels.size() == 2;
+  printf(passed ? "loopback passed\n" : "loopback FAILED\n");
+  return passed ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s port|file|- [directory]\n       %s --loopback [directory]\n", argv[0], argv[0]);
+    return 2;
+  }
+  if (argc > 2) directory = argv[2];
+  if (std::string(argv[1]) == "--loopback") return loopback();
+
+  int fd = open_port(argv[1]);
+  if (fd < 0) {
+    fprintf(stderr, "can't open %s\n", argv[1]);
+    return 2;
+  }
+
+  splitter input;
+  std::uint8_t bytes[512];
+  time_t last_show = 0;
+  while (true) {
+    int size = read(fd, bytes, sizeof(bytes));
+    if (size <= 0) break;
+    input.feed(bytes, size);
+    if (time(nullptr) != last_show) {
+      show();
+      last_show = time(nullptr);
+    }
+  }
+  show();
+  return 0;
+}
@@ -0,0 +1,85 @@
+/**
+ * Times the math that runs every tick against a budget, and fails if any of it goes over.
+ *
+ * Build and run it on your computer, not the robot:
+ *   g++ -std=gnu++20 -O2 -Itools/host -Iinclude tools/tick_benchmark.cpp src/benchmark.cpp src/pursuit.cpp src/path.cpp tools/host/host.cpp -o tick_benchmark
+ *   ./tick_benchmark
+ *
+ * It exits with 1 if a case took longer than its budget, so a change that
+ * makes one slower gets caught without a brain.  The budgets are a few times
+ * what these take on a desktop, they catch something getting much slower,
+ * not a few percent.  The brain is much slower than a desktop, so these
+ * numbers don't say how long a tick takes there.
+ *
+ * The angle math here is tools/host's copy of EZ-Template's, the real one is
+ * in its prebuilt library.  PID and slew only exist in that library, so the
+ * "Benchmark" auton times them on the brain.
+ */
+#include <cstdio>
+
+#include "main.h"
+
+int main() {
+  bench.clear();
+
+  bench.add("wrap_angle", 30, [](int n) { for (int i = 0; i < n; i++) bench.sink(ez::util::wrap_angle(i % 720)); });
+  bench.add("turn_shortest", 30, [](int n) { for (int i = 0; i < n; i++) bench.sink(ez::util::turn_shortest(i % 720, 90)); });
+  bench.add("turn_longest", 30, [](int n) { for (int i = 0; i < n; i++) bench.sink(ez::util::turn_longest(i % 720, 90)); });
+
+  ez::pose a = {0, 0, 0};
+  bench.add("absolute_angle_to_point", 300, [&](int n) { for (int i = 0; i < n; i++) bench.sink(ez::util::absolute_angle_to_point({(double)i, 24}, a)); });
+  bench.add("distance_to_point", 250, [&](int n) { for (int i = 0; i < n; i++) bench.sink(ez::util::distance_to_point({(double)i, 24}, a)); });
+  bench.add("vector_off_point", 80, [&](int n) { for (int i = 0; i < n; i++) bench.sink(ez::util::vector_off_point(i, a).x); });
+
+  // The same arc math odom runs every tick
+  bench.add("odom step", 200, [](int n) {
+    ez::pose p = {0, 0, 0};
+    for (int i = 0; i < n; i++) {
+      double dl = 0.2, dr = 0.21 + (i % 3) * 0.01;
+      double dtheta = (dr - dl) / 12.0;
+      double local = fabs(dtheta) < 1e-9 ? (dl + dr) / 2.0 : 2.0 * sin(dtheta / 2.0) * ((dl + dr) / 2.0 / dtheta);
+      double average = ez::util::to_rad(p.theta) + dtheta / 2.0;
+      p.x += local * sin(average);
+      p.y += local * cos(average);
+      p.theta += ez::util::to_deg(dtheta);
+      bench.sink(p.x);
+    }
+  });
+
+  // This repo's per path work, one op is a whole 200 point path
+  path_buffer path(200);
+  bench.add("path_buffer::smooth (200)", 30000, [&](int n) {
+    for (int i = 0; i < n; i++) {
+      path.clear();
+      for (int k = 0; k < 200; k++)
+        path.push_back({{k * 0.5, (k % 20) * 0.5}, ez::fwd, 127});
+      path.smooth(0.75, 0.03);
+      bench.sink(path.x[100]);
+    }
+  });
+
+  // One op is a pursuit tick with the robot moved a point along the path,
+  // the path starts over when the follower hands the end to the chassis
+  pure_pursuit follower;
+  std::vector<ez::odom> legs = {{{0, 24}, ez::fwd, 110}, {{24, 48}, ez::fwd, 110}, {{24, 96}, ez::fwd, 110}, {{-24, 120}, ez::fwd, 110}};
+  bench.add("pure_pursuit::iterate", 1500, [&](int n) {
+    int index = 0;
+    for (int i = 0; i < n; i++) {
+      if (!follower.enabled()) {
+        chassis.odom_xyt_set(0.0, 0.0, 0.0);
+        chassis.drive_mode_set(ez::DISABLE);
+        follower.pid_pursuit_set(legs);
+        index = 0;
+      }
+      const path_buffer& points = follower.path_buffer_get();
+      index = std::min(index + 1, points.size() - 1);
+      ez::pose current = points.odom_get(index).target;
+      chassis.odom_xyt_set(current.x, current.y, 0.0);
+      follower.iterate();
+      bench.sink(index);
+    }
+  });
+
+  int failed = bench.run(10000, 5);
+  return failed > 0 ? 1 : 0;
+}